@@ -0,0 +1,96 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "csr_graph.h"
+
+#include <cassert>
+
+using namespace std;
+
+csr_graph::csr_graph()
+{}
+
+csr_graph::csr_graph(directed_graph &gr)
+{
+	build(gr);
+}
+
+int csr_graph::build(directed_graph &gr)
+{
+	int n = gr.num_vertices();
+	ip.assign(n + 1, 0);
+	op.assign(n + 1, 0);
+	is.clear();
+	ot.clear();
+	ie.clear();
+	oe.clear();
+	is.reserve(gr.num_edges());
+	ot.reserve(gr.num_edges());
+	ie.reserve(gr.num_edges());
+	oe.reserve(gr.num_edges());
+
+	edge_iterator it1, it2;
+	PEEI pei;
+	for(int v = 0; v < n; v++)
+	{
+		ip[v] = ie.size();
+		for(pei = gr.in_edges(v), it1 = pei.first, it2 = pei.second; it1 != it2; it1++)
+		{
+			is.push_back((*it1)->source());
+			ie.push_back(*it1);
+		}
+		op[v] = oe.size();
+		for(pei = gr.out_edges(v), it1 = pei.first, it2 = pei.second; it1 != it2; it1++)
+		{
+			ot.push_back((*it1)->target());
+			oe.push_back(*it1);
+		}
+	}
+	ip[n] = ie.size();
+	op[n] = oe.size();
+	return 0;
+}
+
+int csr_graph::num_vertices() const
+{
+	return (int)(ip.size()) - 1;
+}
+
+int csr_graph::in_degree(int v) const
+{
+	return ip[v + 1] - ip[v];
+}
+
+int csr_graph::out_degree(int v) const
+{
+	return op[v + 1] - op[v];
+}
+
+vector<int> csr_graph::topological_sort() const
+{
+	int n = num_vertices();
+	vector<int> v;
+	v.reserve(n);
+	vector<int> vd(n, 0);
+	for(int i = 0; i < n; i++)
+	{
+		vd[i] = in_degree(i);
+		if(vd[i] == 0) v.push_back(i);
+	}
+
+	for(int k = 0; k < v.size(); k++)
+	{
+		int x = v[k];
+		for(int j = op[x]; j < op[x + 1]; j++)
+		{
+			int t = ot[j];
+			vd[t]--;
+			assert(vd[t] >= 0);
+			if(vd[t] == 0) v.push_back(t);
+		}
+	}
+	return v;
+}
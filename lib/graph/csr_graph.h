@@ -0,0 +1,41 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __CSR_GRAPH_H__
+#define __CSR_GRAPH_H__
+
+#include <vector>
+
+#include "directed_graph.h"
+
+using namespace std;
+
+// read-only snapshot of a directed graph in compressed sparse row form;
+// edges of each vertex keep the order of the adjacency lists, and the
+// snapshot is invalid once the graph is modified
+class csr_graph
+{
+public:
+	csr_graph();
+	csr_graph(directed_graph &gr);
+
+public:
+	vector<int> ip;				// in-edges of vertex v are [ip[v], ip[v + 1])
+	vector<int> op;				// out-edges of vertex v are [op[v], op[v + 1])
+	vector<int> is;				// source of each in-edge
+	vector<int> ot;				// target of each out-edge
+	vector<edge_descriptor> ie;	// in-edges
+	vector<edge_descriptor> oe;	// out-edges
+
+public:
+	int build(directed_graph &gr);
+	int num_vertices() const;
+	int in_degree(int v) const;
+	int out_degree(int v) const;
+	vector<int> topological_sort() const;
+};
+
+#endif
@@ -24,6 +24,10 @@ directed_graph::directed_graph(const directed_graph &gr)
 	copy(gr);
 }
 
+directed_graph::directed_graph(directed_graph &&gr) noexcept
+	: graph_base(std::move(gr))
+{}
+
 directed_graph& directed_graph::operator=(const directed_graph &gr)
 {
 	copy(gr);
@@ -38,9 +42,7 @@ edge_descriptor directed_graph::add_edge(int s, int t)
 {
 	assert(s >= 0 && s < vv.size());
 	assert(t >= 0 && t < vv.size());
-	edge_base *e = new edge_base(s, t);
-	assert(se.find(e) == se.end());
-	se.insert(e);
+	edge_base *e = new_edge(s, t);
 	vv[s]->add_out_edge(e);
 	vv[t]->add_in_edge(e);
 	return e;
@@ -48,11 +50,10 @@ edge_descriptor directed_graph::add_edge(int s, int t)
 
 int directed_graph::remove_edge(edge_descriptor e)
 {
-	if(se.find(e) == se.end()) return -1;
+	if(contain_edge(e) == false) return -1;
 	vv[e->source()]->remove_out_edge(e);
 	vv[e->target()]->remove_in_edge(e);
-	delete e;
-	se.erase(e);
+	unlink_edge(e);
 	return 0;
 }
 
@@ -6,12 +6,17 @@ See LICENSE for licensing.
 
 #include "edge_base.h"
 #include <cstdio>
+#include <atomic>
 
 using namespace std;
 
+static atomic<int64_t> num_created_edges(0);
+
 edge_base::edge_base(int _s, int _t)
-	:s(_s), t(_t)
-{}
+	:s(_s), t(_t), id(-1)
+{
+	sn = num_created_edges++;
+}
 
 int edge_base::move(int x, int y)
 {
@@ -9,6 +9,12 @@ See LICENSE for licensing.
 
 #include <set>
 #include <map>
+#include <vector>
+#include <iterator>
+#include <stdint.h>
+#include <cstddef>
+
+#include "arena.h"
 
 using namespace std;
 
@@ -22,8 +28,14 @@ public:
 protected:
 	int s;					// source
 	int t;					// target
+	int64_t sn;				// serial number, in order of creation
+	int id;					// index in its graph, stable until clear()
+
+	friend class graph_base;
 
 public:
+	int64_t serial() const { return sn; }
+	int index() const { return id; }
 	virtual int move(int x, int y);
 	virtual int swap();
 	virtual int source() const;
@@ -31,11 +43,56 @@ public:
 	virtual int print() const;
 };
 
+// edges are compared by creation order rather than by address, so that
+// iterating over sets and maps of edges does not depend on the allocator
+namespace std
+{
+	template<> struct less<edge_base*>
+	{
+		bool operator()(const edge_base *x, const edge_base *y) const
+		{
+			if(x == NULL || y == NULL) return x < y;
+			return x->serial() < y->serial();
+		}
+	};
+}
+
 typedef edge_base* edge_descriptor;
-typedef set<edge_base*>::iterator edge_iterator;
+typedef vector<edge_base*, arena_allocator<edge_base*> > edge_list;
+
+// iterator over a contiguous array of edges, skipping removed (NULL) slots;
+// adjacency lists never contain NULL, the edge table of a graph may
+class edge_iterator : public iterator<forward_iterator_tag, edge_base*>
+{
+public:
+	edge_iterator() : p(NULL), q(NULL) {}
+	edge_iterator(edge_base* const *_p, edge_base* const *_q) : p(_p), q(_q) { skip(); }
+
+private:
+	edge_base* const *p;	// current position
+	edge_base* const *q;	// end of the array
+
+public:
+	edge_base* operator*() const { return *p; }
+	edge_iterator& operator++() { p++; skip(); return *this; }
+	edge_iterator operator++(int) { edge_iterator x = *this; p++; skip(); return x; }
+	bool operator==(const edge_iterator &x) const { return p == x.p; }
+	bool operator!=(const edge_iterator &x) const { return p != x.p; }
+
+private:
+	void skip() { while(p != q && *p == NULL) p++; }
+};
+
 typedef pair<edge_descriptor, bool> PEB;
 typedef pair<edge_descriptor, edge_descriptor> PEE;
 typedef map<edge_descriptor, edge_descriptor> MEE;
 typedef pair<edge_iterator, edge_iterator> PEEI;
 
+inline PEEI edge_range(const edge_list &v)
+{
+	edge_base* const *p = v.data();
+	edge_base* const *q = v.data() + v.size();
+	return PEEI(edge_iterator(p, q), edge_iterator(q, q));
+}
+
 #endif
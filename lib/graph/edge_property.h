@@ -0,0 +1,86 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __EDGE_PROPERTY_H__
+#define __EDGE_PROPERTY_H__
+
+#include <vector>
+#include <cassert>
+#include <stdint.h>
+
+#include "edge_base.h"
+#include "arena.h"
+
+using namespace std;
+
+// edge attributes in a dense array indexed by edge_base::index();
+// each slot is tagged with the serial number of the edge it belongs to,
+// which acts as its generation: a slot left by a removed edge, or by an
+// edge of a graph that was cleared, never matches a later edge
+template<typename T>
+class edge_property
+{
+public:
+	edge_property() {}
+
+private:
+	vector<T, arena_allocator<T> > v;				// values
+	vector<int64_t, arena_allocator<int64_t> > g;	// generation of each slot, -1 if empty
+
+public:
+	bool contain(const edge_base *e) const
+	{
+		int k = e->index();
+		return (k >= 0 && k < g.size() && g[k] == e->serial());
+	}
+
+	const T& get(const edge_base *e) const
+	{
+		assert(contain(e));
+		return v[e->index()];
+	}
+
+	// like map::operator[], insert a default value if absent
+	T& operator[](const edge_base *e)
+	{
+		int k = e->index();
+		assert(k >= 0);
+		if(k >= g.size())
+		{
+			v.resize(k + 1);
+			g.resize(k + 1, -1);
+		}
+		if(g[k] != e->serial())
+		{
+			g[k] = e->serial();
+			v[k] = T();
+		}
+		return v[k];
+	}
+
+	int set(const edge_base *e, const T &x)
+	{
+		(*this)[e] = x;
+		return 0;
+	}
+
+	int erase(const edge_base *e)
+	{
+		if(contain(e) == false) return -1;
+		g[e->index()] = -1;
+		v[e->index()] = T();
+		return 0;
+	}
+
+	int clear()
+	{
+		v.clear();
+		g.clear();
+		return 0;
+	}
+};
+
+#endif
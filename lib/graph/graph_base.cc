@@ -15,7 +15,10 @@ See LICENSE for licensing.
 using namespace std;
 
 graph_base::graph_base()
-{}
+{
+	mem = arena::current();
+	ne = 0;
+}
 
 graph_base::~graph_base()
 {
@@ -24,9 +27,21 @@ graph_base::~graph_base()
 
 graph_base::graph_base(const graph_base &gr)
 {
+	mem = arena::current();
+	ne = 0;
 	//copy(gr); !!!
 }
 
+graph_base::graph_base(graph_base &&gr) noexcept
+	: mem(gr.mem), vv(std::move(gr.vv)), ee(std::move(gr.ee)), ne(gr.ne), re(std::move(gr.re))
+{
+	// vertices and edges are taken over along with their arena
+	gr.vv.clear();
+	gr.ee.clear();
+	gr.re.clear();
+	gr.ne = 0;
+}
+
 int graph_base::copy(const graph_base &gr)
 {
 	clear();
@@ -42,7 +57,11 @@ int graph_base::copy(const graph_base &gr)
 
 int graph_base::add_vertex()
 {
-	vertex_base *v = new vertex_base();
+	// the edge sets of the vertex are allocated from the same arena
+	arena_scope as(mem);
+	vertex_base *v = NULL;
+	if(mem == NULL) v = new vertex_base();
+	else v = new (mem->allocate(sizeof(vertex_base))) vertex_base();
 	vv.push_back(v);
 	return 0;
 }
@@ -69,13 +88,54 @@ int graph_base::clear_vertex(int x)
 
 int graph_base::clear()
 {
-	for(int i = 0; i < vv.size(); i++) delete vv[i];
-	for(edge_iterator it = se.begin(); it != se.end(); it++)
+	for(int i = 0; i < vv.size(); i++)
+	{
+		if(mem == NULL) delete vv[i];
+		else vv[i]->~vertex_base();
+	}
+	for(int i = 0; i < ee.size(); i++)
 	{
-		delete (*it);
+		if(ee[i] != NULL) delete_edge(ee[i]);
 	}
+	for(int i = 0; i < re.size(); i++) delete_edge(re[i]);
 	vv.clear();
-	se.clear();
+	ee.clear();
+	re.clear();
+	ne = 0;
+	return 0;
+}
+
+edge_base* graph_base::new_edge(int s, int t)
+{
+	edge_base *e = NULL;
+	if(mem == NULL) e = new edge_base(s, t);
+	else e = new (mem->allocate(sizeof(edge_base))) edge_base(s, t);
+	e->id = ee.size();
+	ee.push_back(e);
+	ne++;
+	return e;
+}
+
+bool graph_base::contain_edge(edge_base *e) const
+{
+	if(e == NULL) return false;
+	if(e->id < 0 || e->id >= ee.size()) return false;
+	return (ee[e->id] == e);
+}
+
+int graph_base::unlink_edge(edge_base *e)
+{
+	assert(contain_edge(e));
+	ee[e->id] = NULL;
+	ne--;
+	re.push_back(e);	// keep it valid as a key of other containers
+	return 0;
+}
+
+int graph_base::delete_edge(edge_base *e)
+{
+	if(mem == NULL) delete e;
+	else e->~edge_base();
 	return 0;
 }
 
@@ -114,7 +174,7 @@ vector<edge_descriptor> graph_base::edges(int s, int t)
 
 PEEI graph_base::edges() const
 {
-	return PEEI(se.begin(), se.end());
+	return edge_range(ee);
 }
 
 set<int> graph_base::adjacent_vertices(int s)
@@ -148,10 +208,26 @@ size_t graph_base::num_vertices() const
 
 size_t graph_base::num_edges() const
 {
-	return se.size();
+	return ne;
+}
+
+size_t graph_base::num_edge_ids() const
+{
+	return ee.size();
+}
+
+edge_descriptor graph_base::get_edge(int k) const
+{
+	assert(k >= 0 && k < ee.size());
+	return ee[k];
 }
 
-int graph_base::get_edge_indices(VE &i2e, MEI &e2i)
+arena* graph_base::get_arena() const
+{
+	return mem;
+}
+
+int graph_base::get_edge_indices(VE &i2e, EPI &e2i)
 {
 	i2e.clear();
 	e2i.clear();
@@ -160,7 +236,7 @@ int graph_base::get_edge_indices(VE &i2e, MEI &e2i)
 	edge_iterator it1 = pei.first, it2 = pei.second;
 	for(; it1 != it2; it1++)
 	{
-		e2i.insert(PEI(*it1, index));
+		e2i[*it1] = index;
 		i2e.push_back(*it1);
 		index++;
 	}
@@ -310,14 +386,15 @@ bool graph_base::check_nested()
 
 int graph_base::print() const
 {
-	printf("total %lu vertices, %lu edges\n", vv.size(), se.size());
+	printf("total %lu vertices, %lu edges\n", vv.size(), num_edges());
 	for(int i = 0; i < vv.size(); i++)
 	{
 		printf("vertex %d: ", i);
 		vv[i]->print();
 	}
 
-	for(edge_iterator it = se.begin(); it != se.end(); it++)
+	PEEI pei = edges();
+	for(edge_iterator it = pei.first; it != pei.second; it++)
 	{
 		(*it)->print();
 	}
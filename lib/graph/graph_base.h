@@ -13,6 +13,7 @@ See LICENSE for licensing.
 
 #include "vertex_base.h"
 #include "edge_base.h"
+#include "edge_property.h"
 
 using namespace std;
 
@@ -21,10 +22,11 @@ typedef pair<int, string> PIS;
 typedef map<edge_descriptor, string> MES;
 typedef pair<edge_descriptor, string> PES;
 typedef map<edge_descriptor, bool> MEB;
-typedef map<edge_descriptor, double> MED;
+typedef map<edge_descriptor, double, less<edge_descriptor>, arena_allocator< pair<const edge_descriptor, double> > > MED;
 typedef pair<edge_descriptor, double> PED;
-typedef map<edge_descriptor, int> MEI;
+typedef map<edge_descriptor, int, less<edge_descriptor>, arena_allocator< pair<const edge_descriptor, int> > > MEI;
 typedef pair<edge_descriptor, int> PEI;
+typedef edge_property<int> EPI;
 typedef vector<edge_descriptor> VE;
 typedef set<edge_descriptor> SE;
 
@@ -33,11 +35,15 @@ class graph_base
 public:
 	graph_base();
 	graph_base(const graph_base &gr);
+	graph_base(graph_base &&gr) noexcept;
 	virtual ~graph_base();
 
 protected:
+	arena *mem;					// arena of vertices and edges, NULL for heap
 	vector<vertex_base*> vv;
-	set<edge_base*> se;
+	edge_list ee;				// edges indexed by id, NULL if removed
+	int ne;						// number of edges
+	vector<edge_base*> re;		// removed edges, released in clear()
 
 public:
 	// modify the graph
@@ -53,13 +59,16 @@ public:
 	virtual size_t support_size() const;
 	virtual size_t num_vertices() const;
 	virtual size_t num_edges() const;
+	virtual size_t num_edge_ids() const;
+	virtual edge_descriptor get_edge(int k) const;
 	virtual int degree(int v) const;
 	virtual PEB edge(int s, int t);
 	virtual PEEI edges() const;
 	virtual vector<edge_descriptor> edges(int x, int y);
 	virtual set<int> adjacent_vertices(int v);
 	virtual PEEI out_edges(int x) = 0;
-	virtual int get_edge_indices(VE &e2i, MEI &i2e);
+	virtual int get_edge_indices(VE &i2e, EPI &e2i);
+	arena* get_arena() const;
 
 	// algorithms
 	virtual int bfs(int s, vector<int> &v);
@@ -74,6 +83,12 @@ public:
 	// draw
 	virtual int draw(const string &file, const MIS &mis, const MES &mes, double len) = 0;
 	virtual int print() const;
+
+protected:
+	edge_base* new_edge(int s, int t);
+	bool contain_edge(edge_base *e) const;
+	int unlink_edge(edge_base *e);
+	int delete_edge(edge_base *e);
 };
 
 #endif
@@ -10,6 +10,7 @@ See LICENSE for licensing.
 #include <cstdio>
 #include <cassert>
 #include <cstdio>
+#include <algorithm>
 
 using namespace std;
 
@@ -21,29 +22,44 @@ vertex_base::~vertex_base()
 
 int vertex_base::add_in_edge(edge_base *e)
 {
-	assert(si.find(e) == si.end());
-	si.insert(e);
-	return 0;
+	return insert_edge(si, e);
 }
 
 int vertex_base::add_out_edge(edge_base *e)
 {
-	assert(so.find(e) == so.end());
-	so.insert(e);
-	return 0;
+	return insert_edge(so, e);
 }
 
 int vertex_base::remove_in_edge(edge_base *e)
 {
-	assert(si.find(e) != si.end());
-	si.erase(e);
-	return 0;
+	return erase_edge(si, e);
 }
 
 int vertex_base::remove_out_edge(edge_base *e)
 {
-	assert(so.find(e) != so.end());
-	so.erase(e);
+	return erase_edge(so, e);
+}
+
+int vertex_base::insert_edge(edge_list &v, edge_base *e)
+{
+	// new edges come last; only moved edges need a search
+	less<edge_base*> cmp;
+	if(v.size() == 0 || cmp(v.back(), e))
+	{
+		v.push_back(e);
+		return 0;
+	}
+	edge_list::iterator it = lower_bound(v.begin(), v.end(), e, cmp);
+	assert(it == v.end() || (*it) != e);
+	v.insert(it, e);
+	return 0;
+}
+
+int vertex_base::erase_edge(edge_list &v, edge_base *e)
+{
+	edge_list::iterator it = find(v.begin(), v.end(), e);
+	assert(it != v.end());
+	v.erase(it);
 	return 0;
 }
 
@@ -64,25 +80,25 @@ int vertex_base::out_degree() const
 
 PEEI vertex_base::in_edges() const
 {
-	return PEEI(si.begin(), si.end());
+	return edge_range(si);
 }
 
 PEEI vertex_base::out_edges() const
 {
-	return PEEI(so.begin(), so.end());
+	return edge_range(so);
 }
 
 int vertex_base::print() const
 {
 	printf("in-edges = ( ");
-	for(edge_iterator it = si.begin(); it != si.end(); it++)
+	for(int i = 0; i < si.size(); i++)
 	{
-		printf("[%d, %d] ", (*it)->source(), (*it)->target());
+		printf("[%d, %d] ", si[i]->source(), si[i]->target());
 	}
 	printf("), out-edges = ( ");
-	for(edge_iterator it = so.begin(); it != so.end(); it++)
+	for(int i = 0; i < so.size(); i++)
 	{
-		printf("[%d, %d] ", (*it)->source(), (*it)->target());
+		printf("[%d, %d] ", so[i]->source(), so[i]->target());
 	}
 	printf(")\n");
 	return 0;
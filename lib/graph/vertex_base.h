@@ -19,8 +19,8 @@ public:
 	virtual ~vertex_base();
 
 protected:
-	set<edge_base*> si;		// in_edges
-	set<edge_base*> so;		// out_edges
+	edge_list si;			// in_edges, in order of creation
+	edge_list so;			// out_edges, in order of creation
 
 public:
 	virtual int add_in_edge(edge_base *e);
@@ -33,6 +33,10 @@ public:
 	virtual PEEI in_edges() const;
 	virtual PEEI out_edges() const;
 	virtual int print() const;
+
+private:
+	static int insert_edge(edge_list &v, edge_base *e);
+	static int erase_edge(edge_list &v, edge_base *e);
 };
 
 #endif
@@ -11,6 +11,7 @@ See LICENSE for licensing.
 #include <vector>
 #include <set>
 #include <map>
+#include <unordered_map>
 
 #include "item.h"
 #include "transcript.h"
@@ -21,7 +22,7 @@ class gene
 {
 public:
 	vector<transcript> transcripts;			
-	map<string, int> t2i;
+	unordered_map<string, int> t2i;
 
 public:
 	// build
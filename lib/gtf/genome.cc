@@ -8,6 +8,12 @@ See LICENSE for licensing.
 #include <cassert>
 #include <sstream>
 #include <map>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "genome.h"
 #include "util.h"
@@ -33,40 +39,94 @@ int genome::add_gene(const gene &g)
 	return 0;
 }
 
-int genome::read(const string &file)
+// parse the lines in [s, s + n)
+static int parse_lines(const char *s, size_t n, vector<item> *v)
+{
+	const char *e = s + n;
+	while(s < e)
+	{
+		const char *q = (const char*)memchr(s, '\n', e - s);
+		if(q == NULL) q = e;
+		v->push_back(item());
+		v->back().parse(s, q - s);
+		s = q + 1;
+	}
+	return 0;
+}
+
+int genome::read(const string &file, int threads)
 {
 	if(file == "") return 0;
 
-	ifstream fin(file.c_str());
-	if(fin.fail())
+	int fd = open(file.c_str(), O_RDONLY);
+	struct stat st;
+	if(fd < 0 || fstat(fd, &st) != 0)
 	{
 		printf("open file %s error\n", file.c_str());
+		if(fd >= 0) close(fd);
 		return 0;
 	}
 
-	char line[102400];
-	
 	genes.clear();
 	g2i.clear();
-	while(fin.getline(line, 102400, '\n'))
+
+	// the file is mapped and parsed in place
+	size_t n = st.st_size;
+	const char *s = NULL;
+	if(n >= 1) s = (const char*)mmap(NULL, n, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if(s == MAP_FAILED)
+	{
+		printf("open file %s error\n", file.c_str());
+		return 0;
+	}
+
+	if(threads <= 1)
 	{
-		item ge(line);
-		if(g2i.find(ge.gene_id) == g2i.end())
+		item ge;
+		const char *p = s;
+		const char *e = s + n;
+		while(p < e)
 		{
-			gene gg;
-			if(ge.feature == "transcript") gg.add_transcript(ge);
-			else if(ge.feature == "exon") gg.add_exon(ge);
-			g2i.insert(pair<string, int>(ge.gene_id, genes.size()));
-			genes.push_back(gg);
+			const char *q = (const char*)memchr(p, '\n', e - p);
+			if(q == NULL) q = e;
+			ge.parse(p, q - p);
+			add_item(ge);
+			p = q + 1;
 		}
-		else
+	}
+	else
+	{
+		// in rounds, chunks split at line boundaries are parsed
+		// in parallel, and the items are added in file order
+		size_t c = 4 << 20;
+		size_t p = 0;
+		while(p < n)
 		{
-			int k = g2i[ge.gene_id];
-			if(ge.feature == "transcript") genes[k].add_transcript(ge);
-			else if(ge.feature == "exon") genes[k].add_exon(ge);
+			vector<size_t> b(1, p);
+			for(int i = 0; i < threads && p < n; i++)
+			{
+				size_t q = (p + c < n) ? p + c : n;
+				const char *x = (const char*)memchr(s + q, '\n', n - q);
+				p = (x == NULL) ? n : x - s + 1;
+				b.push_back(p);
+			}
+
+			vector< vector<item> > vv(b.size() - 1);
+			vector<thread> ts;
+			for(int i = 0; i < vv.size(); i++) ts.push_back(thread(parse_lines, s + b[i], b[i + 1] - b[i], &vv[i]));
+			for(int i = 0; i < ts.size(); i++) ts[i].join();
+
+			for(int i = 0; i < vv.size(); i++)
+			{
+				for(int k = 0; k < vv[i].size(); k++) add_item(vv[i][k]);
+			}
 		}
 	}
 
+	if(s != NULL) munmap((void*)s, n);
+
 	for(int i = 0; i < genes.size(); i++)
 	{
 		genes[i].sort();
@@ -76,6 +136,25 @@ int genome::read(const string &file)
 	return 0;
 }
 
+int genome::add_item(const item &ge)
+{
+	if(g2i.find(ge.gene_id) == g2i.end())
+	{
+		gene gg;
+		if(ge.feature == "transcript") gg.add_transcript(ge);
+		else if(ge.feature == "exon") gg.add_exon(ge);
+		g2i.insert(pair<string, int>(ge.gene_id, genes.size()));
+		genes.push_back(gg);
+	}
+	else
+	{
+		int k = g2i[ge.gene_id];
+		if(ge.feature == "transcript") genes[k].add_transcript(ge);
+		else if(ge.feature == "exon") genes[k].add_exon(ge);
+	}
+	return 0;
+}
+
 int genome::write(const string &file) const
 {
 	ofstream fout(file.c_str());
@@ -98,7 +177,7 @@ int genome::sort()
 
 const gene* genome::get_gene(string name) const
 {
-	map<string, int>::const_iterator it = g2i.find(name);
+	unordered_map<string, int>::const_iterator it = g2i.find(name);
 	if(it == g2i.end()) return NULL;
 	int k = it->second;
 	return &(genes[k]);
@@ -9,6 +9,7 @@ See LICENSE for licensing.
 
 #include <string>
 #include <map>
+#include <unordered_map>
 #include "gene.h"
 
 using namespace std;
@@ -22,11 +23,11 @@ public:
 
 public:
 	vector<gene> genes;
-	map<string, int> g2i;
+	unordered_map<string, int> g2i;
 
 public:
 	// read and write
-	int read(const string &file);
+	int read(const string &file, int threads = 1);
 	int write(const string &file) const;
 
 	// modify
@@ -45,6 +46,9 @@ public:
 	const gene* get_gene(string name) const;
 	const gene* locate_gene(const string &chr, const PI32 &p) const;
 	vector<transcript> collect_transcripts() const;
+
+private:
+	int add_item(const item &ge);
 };
 
 #endif
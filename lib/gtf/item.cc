@@ -12,6 +12,17 @@ See LICENSE for licensing.
 #include <cassert>
 #include <cstdio>
 #include <cmath>
+#include <cstring>
+#include <cctype>
+
+item::item()
+{
+	start = end = 0;
+	score = -1;
+	strand = '.';
+	frame = '.';
+	coverage = FPKM = RPKM = TPM = 0;
+}
 
 item::item(const string &s)
 {
@@ -20,58 +31,95 @@ item::item(const string &s)
 
 int item::parse(const string &s)
 {
-	char buf[10240];
-	stringstream sstr(s);
-	sstr>>buf;
-	seqname.assign(buf);
-	sstr>>buf;
-	source.assign(buf);
-	sstr>>buf;
-	feature.assign(buf);
-	sstr>>start>>end;
-	start--;			// TODO gtf: (from 1, both inclusive)
-	sstr>>buf;
-	if(buf[0] == '.') score = -1;
-	else score = atof(buf);
-	sstr>>buf;
-	strand = buf[0];
-	sstr>>buf;
-	frame = buf[0];
-
-	char buf2[10240];
-	coverage = 0;
-	RPKM = 0;
-	TPM = 0;
-	while(sstr.eof() == false)
+	return parse(s.c_str(), s.size());
+}
+
+// next white-space separated token in [p, e), advance p beyond it
+static bool next_token(const char *&p, const char *e, const char *&t, int &n)
+{
+	while(p < e && isspace(*p)) p++;
+	if(p >= e) return false;
+	t = p;
+	while(p < e && isspace(*p) == false) p++;
+	n = p - t;
+	return true;
+}
+
+static bool equal(const char *t, int n, const char *x)
+{
+	return (strlen(x) == n && strncmp(t, x, n) == 0);
+}
+
+static int32_t to_int(const char *t, int n)
+{
+	return atoi(string(t, n).c_str());
+}
+
+static double to_double(const char *t, int n)
+{
+	return atof(string(t, n).c_str());
+}
+
+int item::parse(const char *s, int n)
+{
+	const char *p = s;
+	const char *e = s + n;
+	const char *t = NULL;
+	int k = 0;
+
+	seqname.clear();
+	source.clear();
+	feature.clear();
+	gene_id.clear();
+	transcript_id.clear();
+	transcript_type.clear();
+	gene_type.clear();
+	start = end = 0;
+	score = -1;
+	strand = '.';
+	frame = '.';
+	coverage = FPKM = RPKM = TPM = 0;
+
+	if(next_token(p, e, t, k)) seqname.assign(t, k);
+	if(next_token(p, e, t, k)) source.assign(t, k);
+	if(next_token(p, e, t, k)) feature.assign(t, k);
+	if(next_token(p, e, t, k)) start = to_int(t, k) - 1;		// TODO gtf: (from 1, both inclusive)
+	if(next_token(p, e, t, k)) end = to_int(t, k);
+	if(next_token(p, e, t, k)) score = (t[0] == '.') ? -1 : to_double(t, k);
+	if(next_token(p, e, t, k)) strand = t[0];
+	if(next_token(p, e, t, k)) frame = t[0];
+
+	// attributes: key "value"; the value is taken between the outer quotes
+	while(next_token(p, e, t, k))
 	{
-		sstr>>buf;
-		/*
-		sstr.getline(buf2, 10240, '"');
-		sstr.getline(buf2, 10240, '"');
-		*/
-		sstr.getline(buf2, 10240, ';');
-		string v(buf2);
-		int k1 = v.find('"');
-		int k2 = v.rfind('"');
-		if(k1 >= 0 && k1 < k2 && k2 < v.size()) v = v.substr(k1 + 1, k2 - k1 - 1);
-
-		if(string(buf) == "" || v == "") break;
-
-		//printf("|%s|%s|\n", buf, v.c_str());
-
-		if(string(buf) == "transcript_id") transcript_id = v;
-		else if(string(buf) == "transcript_type") transcript_type = v;
-		else if(string(buf) == "gene_type") gene_type = v;
-		else if(string(buf) == "gene_id") gene_id = v;
-		else if(string(buf) == "cov") coverage = atof(v.c_str());
-		else if(string(buf) == "coverage") coverage = atof(v.c_str());
-		else if(string(buf) == "expression") coverage = atof(v.c_str());
-		else if(string(buf) == "expr") coverage = atof(v.c_str());
-		else if(string(buf) == "TPM") TPM = atof(v.c_str());
-		else if(string(buf) == "RPKM") RPKM = atof(v.c_str());
-		else if(string(buf) == "FPKM") FPKM = atof(v.c_str());
-
-		//sstr.getline(buf2, 10240, ';');
+		const char *v = p;
+		const char *q = (const char*)memchr(p, ';', e - p);
+		if(q == NULL) q = e;
+		int m = q - v;
+
+		const char *a = (const char*)memchr(v, '"', m);
+		const char *b = q - 1;
+		while(a != NULL && b > a && *b != '"') b--;
+		if(a != NULL && a < b)
+		{
+			v = a + 1;
+			m = b - a - 1;
+		}
+
+		p = (q < e) ? q + 1 : e;
+		if(m <= 0) break;
+
+		if(equal(t, k, "transcript_id")) transcript_id.assign(v, m);
+		else if(equal(t, k, "transcript_type")) transcript_type.assign(v, m);
+		else if(equal(t, k, "gene_type")) gene_type.assign(v, m);
+		else if(equal(t, k, "gene_id")) gene_id.assign(v, m);
+		else if(equal(t, k, "cov")) coverage = to_double(v, m);
+		else if(equal(t, k, "coverage")) coverage = to_double(v, m);
+		else if(equal(t, k, "expression")) coverage = to_double(v, m);
+		else if(equal(t, k, "expr")) coverage = to_double(v, m);
+		else if(equal(t, k, "TPM")) TPM = to_double(v, m);
+		else if(equal(t, k, "RPKM")) RPKM = to_double(v, m);
+		else if(equal(t, k, "FPKM")) FPKM = to_double(v, m);
 	}
 
 	return 0;
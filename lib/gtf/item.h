@@ -15,10 +15,12 @@ using namespace std;
 class item
 {
 public:
+	item();
 	item(const string &s);
 
 public:
 	int parse(const string &s);
+	int parse(const char *s, int n);	// parse one line of n characters
 	bool operator<(const item &ge) const;
 	int print() const;
 	int length() const;
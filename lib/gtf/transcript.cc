@@ -192,7 +192,7 @@ string transcript::label() const
 	return string(buf);
 }
 
-int transcript::write(ostream &fout) const
+int transcript::write(ostream &fout, bool with_RPKM) const
 {
 	fout.precision(4);
 	fout<<fixed;
@@ -213,7 +213,7 @@ int transcript::write(ostream &fout) const
 	fout<<"transcript_id \""<<transcript_id.c_str()<<"\"; ";
 	if(gene_type != "") fout<<"gene_type \""<<gene_type.c_str()<<"\"; ";
 	if(transcript_type != "") fout<<"transcript_type \""<<transcript_type.c_str()<<"\"; ";
-	fout<<"RPKM \""<<RPKM<<"\"; ";
+	if(with_RPKM == true) fout<<"RPKM \""<<RPKM<<"\"; ";
 	fout<<"cov \""<<coverage<<"\";"<<endl;
 
 	for(int k = 0; k < exons.size(); k++)
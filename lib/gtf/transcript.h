@@ -62,7 +62,7 @@ public:
 	vector<PI32> get_intron_chain() const;
 	bool intron_chain_match(const transcript &t) const;
 	string label() const;
-	int write(ostream &fout) const;
+	int write(ostream &fout, bool with_RPKM = true) const;
 };
 
 #endif
@@ -0,0 +1,119 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "arena.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+
+arena::arena()
+{
+	cur = NULL;
+	left = 0;
+	next = ARENA_MIN_CHUNK;
+	total = 0;
+	count = 0;
+	memset(bins, 0, sizeof(bins));
+}
+
+arena::~arena()
+{
+	clear();
+}
+
+void* arena::allocate(size_t n)
+{
+	count++;
+	if(n == 0) n = 1;
+	n = (n + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+
+	int b = n / ARENA_ALIGNMENT - 1;
+	if(b < ARENA_NUM_BINS && bins[b] != NULL)
+	{
+		void *p = bins[b];
+		bins[b] = *((void**)(p));
+		return p;
+	}
+
+	if(n > left)
+	{
+		// the rest of the current chunk is wasted
+		while(next < n) next *= 2;
+		char *c = (char*)(malloc(next));
+		if(c == NULL) throw bad_alloc();
+		chunks.push_back(c);
+		total += next;
+		cur = c;
+		left = next;
+		if(next < ARENA_MAX_CHUNK) next *= 2;
+	}
+
+	void *p = cur;
+	cur += n;
+	left -= n;
+	return p;
+}
+
+int arena::deallocate(void *p, size_t n)
+{
+	if(p == NULL) return 0;
+	if(n == 0) n = 1;
+	n = (n + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+
+	// larger blocks are only released with the arena
+	int b = n / ARENA_ALIGNMENT - 1;
+	if(b >= ARENA_NUM_BINS) return 0;
+
+	*((void**)(p)) = bins[b];
+	bins[b] = p;
+	return 0;
+}
+
+int arena::clear()
+{
+	for(int i = 0; i < chunks.size(); i++) free(chunks[i]);
+	chunks.clear();
+	cur = NULL;
+	left = 0;
+	next = ARENA_MIN_CHUNK;
+	total = 0;
+	count = 0;
+	memset(bins, 0, sizeof(bins));
+	return 0;
+}
+
+size_t arena::capacity() const
+{
+	return total;
+}
+
+size_t arena::num_allocations() const
+{
+	return count;
+}
+
+arena*& arena::current_ref()
+{
+	static thread_local arena *a = NULL;
+	return a;
+}
+
+arena* arena::current()
+{
+	return current_ref();
+}
+
+arena_scope::arena_scope(arena *a)
+{
+	prev = arena::current_ref();
+	arena::current_ref() = a;
+}
+
+arena_scope::~arena_scope()
+{
+	arena::current_ref() = prev;
+}
@@ -0,0 +1,125 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+#define ARENA_ALIGNMENT 16
+#define ARENA_NUM_BINS 32				// blocks up to 32 * 16 bytes are recycled
+#define ARENA_MIN_CHUNK (64 << 10)
+#define ARENA_MAX_CHUNK (16 << 20)
+
+// memory pool for the objects of one bundle: blocks are carved from large
+// chunks, freed small blocks are recycled by size, and all memory is
+// released at once by clear() or the destructor; not thread-safe, an
+// arena is used by one thread at a time
+class arena
+{
+public:
+	arena();
+	~arena();
+
+private:
+	vector<char*> chunks;				// allocated chunks
+	char *cur;							// free space of the current chunk
+	size_t left;						// size of free space of the current chunk
+	size_t next;						// size of next chunk
+	void *bins[ARENA_NUM_BINS];			// lists of freed blocks, by size
+	size_t total;						// total size of chunks
+	size_t count;						// number of blocks allocated
+
+public:
+	void *allocate(size_t n);
+	int deallocate(void *p, size_t n);
+	int clear();
+	size_t capacity() const;
+	size_t num_allocations() const;
+
+	static arena *current();			// arena of this thread, NULL for heap
+
+private:
+	friend class arena_scope;
+	static arena *&current_ref();
+};
+
+// make an arena (or the heap, with NULL) current for this thread
+// during the lifetime of the scope
+class arena_scope
+{
+public:
+	arena_scope(arena *a);
+	~arena_scope();
+
+private:
+	arena *prev;
+};
+
+// STL allocator drawing from the arena current at construction; it is
+// copied along with containers, so a container always frees into the
+// arena it allocated from
+template<typename T>
+class arena_allocator
+{
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+	template<typename U> struct rebind { typedef arena_allocator<U> other; };
+
+public:
+	arena *a;
+
+public:
+	arena_allocator() : a(arena::current()) {}
+	arena_allocator(const arena_allocator &x) : a(x.a) {}
+	template<typename U> arena_allocator(const arena_allocator<U> &x) : a(x.a) {}
+
+	pointer allocate(size_type n, const void * = 0)
+	{
+		if(a == NULL) return (pointer)(::operator new(n * sizeof(T)));
+		return (pointer)(a->allocate(n * sizeof(T)));
+	}
+
+	void deallocate(pointer p, size_type n)
+	{
+		if(a == NULL) ::operator delete(p);
+		else a->deallocate(p, n * sizeof(T));
+	}
+
+	template<typename U, typename... Args> void construct(U *p, Args&&... args) { ::new((void*)p) U(std::forward<Args>(args)...); }
+	template<typename U> void destroy(U *p) { p->~U(); }
+	size_type max_size() const { return size_t(-1) / sizeof(T); }
+	pointer address(reference x) const { return &x; }
+	const_pointer address(const_reference x) const { return &x; }
+
+	// a copy made elsewhere must not hold on to this arena
+	arena_allocator select_on_container_copy_construction() const { return arena_allocator(); }
+};
+
+template<typename T, typename U>
+bool operator==(const arena_allocator<T> &x, const arena_allocator<U> &y)
+{
+	return x.a == y.a;
+}
+
+template<typename T, typename U>
+bool operator!=(const arena_allocator<T> &x, const arena_allocator<U> &y)
+{
+	return x.a != y.a;
+}
+
+#endif
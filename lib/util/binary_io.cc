@@ -0,0 +1,49 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "binary_io.h"
+
+int binary_writer::put(const string &s)
+{
+	put((uint32_t)(s.size()));
+	data.append(s);
+	return 0;
+}
+
+int binary_writer::clear()
+{
+	data.clear();
+	return 0;
+}
+
+binary_reader::binary_reader(const char *p, size_t n)
+	: cur(p), end(p + n), bad(false)
+{}
+
+int binary_reader::get(string &s)
+{
+	uint32_t n;
+	s.clear();
+	if(get(n) != 0) return -1;
+	if(cur + n > end)
+	{
+		bad = true;
+		return -1;
+	}
+	s.assign(cur, n);
+	cur += n;
+	return 0;
+}
+
+bool binary_reader::fail() const
+{
+	return bad;
+}
+
+bool binary_reader::done() const
+{
+	return (bad == false && cur == end);
+}
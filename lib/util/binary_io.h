@@ -0,0 +1,65 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __BINARY_IO_H__
+#define __BINARY_IO_H__
+
+#include <stdint.h>
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+// fixed-width values in host byte order (little-endian on all
+// supported platforms), appended to a string
+class binary_writer
+{
+public:
+	string data;
+
+public:
+	template<typename T> int put(const T &x)
+	{
+		data.append((const char*)(&x), sizeof(T));
+		return 0;
+	}
+
+	int put(const string &s);
+	int clear();
+};
+
+// reading from a buffer; once a read runs past the end,
+// fail() is set and every later read returns zeros
+class binary_reader
+{
+public:
+	binary_reader(const char *p, size_t n);
+
+private:
+	const char *cur;
+	const char *end;
+	bool bad;
+
+public:
+	template<typename T> int get(T &x)
+	{
+		if(bad == true || cur + sizeof(T) > end)
+		{
+			bad = true;
+			memset(&x, 0, sizeof(T));
+			return -1;
+		}
+		memcpy(&x, cur, sizeof(T));
+		cur += sizeof(T);
+		return 0;
+	}
+
+	int get(string &s);
+	bool fail() const;
+	bool done() const;
+};
+
+#endif
@@ -0,0 +1,98 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "bitmap.h"
+
+#include <cassert>
+
+bitmap::bitmap()
+	: n(0)
+{}
+
+int bitmap::set(int i)
+{
+	assert(i >= 0);
+	int k = i >> 6;
+	if(k >= w.size()) w.resize(k + 1, 0);
+	uint64_t m = ((uint64_t)1) << (i & 63);
+	if((w[k] & m) != 0) return 0;
+	w[k] |= m;
+	n++;
+	return 0;
+}
+
+int bitmap::reset(int i)
+{
+	assert(i >= 0);
+	int k = i >> 6;
+	if(k >= w.size()) return 0;
+	uint64_t m = ((uint64_t)1) << (i & 63);
+	if((w[k] & m) == 0) return 0;
+	w[k] &= ~m;
+	n--;
+	return 0;
+}
+
+bool bitmap::test(int i) const
+{
+	int k = i >> 6;
+	if(i < 0 || k >= w.size()) return false;
+	return ((w[k] >> (i & 63)) & 1) != 0;
+}
+
+bool bitmap::empty() const
+{
+	return (n == 0);
+}
+
+int bitmap::count() const
+{
+	return n;
+}
+
+int bitmap::clear()
+{
+	w.assign(w.size(), 0);
+	n = 0;
+	return 0;
+}
+
+int bitmap::next(int i) const
+{
+	if(i < 0) i = 0;
+	int k = i >> 6;
+	if(k >= w.size()) return -1;
+	uint64_t x = w[k] & (~((uint64_t)0) << (i & 63));
+	while(x == 0)
+	{
+		k++;
+		if(k >= w.size()) return -1;
+		x = w[k];
+	}
+	return (k << 6) + __builtin_ctzll(x);
+}
+
+int bitmap::assign(const bitmap &b)
+{
+	if(w.size() < b.w.size()) w.resize(b.w.size());
+	for(int k = 0; k < b.w.size(); k++) w[k] = b.w[k];
+	for(int k = b.w.size(); k < w.size(); k++) w[k] = 0;
+	n = b.n;
+	return 0;
+}
+
+int bitmap::intersect(const bitmap &b)
+{
+	int m = (w.size() < b.w.size()) ? w.size() : b.w.size();
+	n = 0;
+	for(int k = 0; k < m; k++)
+	{
+		w[k] &= b.w[k];
+		n += __builtin_popcountll(w[k]);
+	}
+	for(int k = m; k < w.size(); k++) w[k] = 0;
+	return 0;
+}
@@ -0,0 +1,39 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __BITMAP_H__
+#define __BITMAP_H__
+
+#include <stdint.h>
+#include <vector>
+
+#include "arena.h"
+
+using namespace std;
+
+// growable dense bitset over 64-bit words
+class bitmap
+{
+public:
+	bitmap();
+
+private:
+	vector<uint64_t, arena_allocator<uint64_t> > w;	// words, bit i in w[i / 64]
+	int n;												// number of set bits
+
+public:
+	int set(int i);
+	int reset(int i);
+	bool test(int i) const;
+	bool empty() const;
+	int count() const;
+	int clear();
+	int next(int i) const;						// first set bit >= i, or -1
+	int assign(const bitmap &b);				// copy without releasing words
+	int intersect(const bitmap &b);				// word-wise and
+};
+
+#endif
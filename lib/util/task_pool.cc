@@ -0,0 +1,103 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "task_pool.h"
+#include "arena.h"
+
+task_pool::task_pool()
+{
+	stopped = false;
+}
+
+task_pool::~task_pool()
+{
+	stop();
+}
+
+int task_pool::start(int n)
+{
+	stopped = false;
+	for(int i = 0; i < n; i++) helpers.push_back(thread(&task_pool::work, this));
+	return 0;
+}
+
+int task_pool::stop()
+{
+	lock.lock();
+	stopped = true;
+	lock.unlock();
+	ready.notify_all();
+
+	for(int i = 0; i < helpers.size(); i++) helpers[i].join();
+	helpers.clear();
+	return 0;
+}
+
+int task_pool::size() const
+{
+	return helpers.size();
+}
+
+int task_pool::run(vector<task> &tasks)
+{
+	if(helpers.size() == 0 || tasks.size() <= 1)
+	{
+		for(int i = 0; i < tasks.size(); i++) tasks[i]();
+		return 0;
+	}
+
+	task_group g;
+	g.q.assign(tasks.begin(), tasks.end());
+	g.pending = tasks.size();
+
+	unique_lock<mutex> lk(lock);
+	groups.push_back(&g);
+	ready.notify_all();
+
+	while(g.q.size() >= 1)
+	{
+		task t = g.q.front();
+		g.q.pop_front();
+		if(g.q.size() == 0) groups.remove(&g);
+
+		lk.unlock();
+		t();
+		lk.lock();
+		g.pending--;
+	}
+
+	// wait for the tasks taken by the helpers
+	while(g.pending >= 1) g.done.wait(lk);
+	return 0;
+}
+
+int task_pool::work()
+{
+	unique_lock<mutex> lk(lock);
+	while(true)
+	{
+		while(stopped == false && groups.size() == 0) ready.wait(lk);
+		if(groups.size() == 0) break;
+
+		// steal from the oldest group, whose owner has waited the longest
+		task_group *g = groups.front();
+		task t = g->q.back();
+		g->q.pop_back();
+		if(g->q.size() == 0) groups.pop_front();
+
+		lk.unlock();
+		{
+			arena a;
+			arena_scope as(&a);
+			t();
+		}
+		lk.lock();
+
+		g->pending--;
+		if(g->pending == 0) g->done.notify_one();
+	}
+	return 0;
+}
@@ -0,0 +1,57 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __TASK_POOL_H__
+#define __TASK_POOL_H__
+
+#include <deque>
+#include <list>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+
+using namespace std;
+
+typedef function<void()> task;
+
+// tasks submitted together by one thread
+class task_group
+{
+public:
+	deque<task> q;					// tasks not yet started
+	int pending;					// tasks not yet finished
+	condition_variable done;		// signaled when pending drops to 0
+};
+
+// helper threads stealing tasks from the groups of busy threads: the
+// submitting thread runs its own tasks from the front, while idle helpers
+// take them from the back; each stolen task runs in a fresh arena
+class task_pool
+{
+public:
+	task_pool();
+	~task_pool();
+
+private:
+	vector<thread> helpers;
+	list<task_group*> groups;		// groups with tasks not yet started
+	bool stopped;
+	mutex lock;						// protect groups, stopped and every group
+	condition_variable ready;		// signaled when tasks are added or stopped
+
+public:
+	int start(int n);				// start n helper threads
+	int stop();						// wait for the helpers to finish
+	int size() const;				// number of helper threads
+	int run(vector<task> &tasks);	// run all tasks, return when all are done
+
+private:
+	int work();
+};
+
+#endif
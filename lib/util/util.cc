@@ -21,3 +21,38 @@ vector<int> get_random_permutation(int n)
 }
 
 
+
+int radix_sort(vector<PU64I> &v)
+{
+	if(v.size() <= 1) return 0;
+
+	uint64_t lo = ~(uint64_t)(0), hi = 0;
+	for(int i = 0; i < v.size(); i++)
+	{
+		lo &= v[i].first;
+		hi |= v[i].first;
+	}
+
+	vector<PU64I> w(v.size());
+	vector<int> c(1 << 16);
+	for(int s = 0; s < 64; s += 16)
+	{
+		// skip digits shared by all keys
+		if((((lo ^ hi) >> s) & 0xffff) == 0) continue;
+
+		c.assign(1 << 16, 0);
+		for(int i = 0; i < v.size(); i++) c[(v[i].first >> s) & 0xffff]++;
+
+		int n = 0;
+		for(int k = 0; k < c.size(); k++)
+		{
+			int x = c[k];
+			c[k] = n;
+			n += x;
+		}
+
+		for(int i = 0; i < v.size(); i++) w[c[(v[i].first >> s) & 0xffff]++] = v[i];
+		v.swap(w);
+	}
+	return 0;
+}
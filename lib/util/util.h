@@ -30,6 +30,7 @@ typedef map<int32_t, int> MPI;
 typedef pair<int32_t, int> PPI;
 typedef pair<int, int> PI;
 typedef map<int, int> MI;
+typedef pair<uint64_t, int> PU64I;
 
 // common small functions
 template<typename T>
@@ -170,4 +171,7 @@ vector<K> get_keys(const map<K, V> &m)
 
 vector<int> get_random_permutation(int n);
 
+// stable LSD radix sort by the 64-bit key, 16 bits per pass
+int radix_sort(vector<PU64I> &v);
+
 #endif
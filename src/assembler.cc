@@ -6,9 +6,12 @@ See LICENSE for licensing.
 
 #include <cstdio>
 #include <cassert>
+#include <climits>
+#include <cmath>
 #include <sstream>
 
 #include "config.h"
+#include "arena.h"
 #include "gtf.h"
 #include "genome.h"
 #include "assembler.h"
@@ -16,30 +19,156 @@ See LICENSE for licensing.
 #include "sgraph_compare.h"
 #include "super_graph.h"
 #include "filter.h"
+#include "profiler.h"
 
 assembler::assembler()
+	: bq(batch_bundle_size)
 {
-    sfn = sam_open(input_file.c_str(), "r");
-    hdr = sam_hdr_read(sfn);
-    b1t = bam_init1();
-	index = 0;
+	sfn = NULL;
+	hdr = NULL;
+	idx = NULL;
+
+	// when resuming from a checkpoint, the input is not read
+	if(resume_file == "")
+	{
+		sfn = sam_open(input_file.c_str(), "r");
+		if(num_hts_threads >= 1) hts_set_threads(sfn, num_hts_threads);
+		hdr = sam_hdr_read(sfn);
+		if(num_threads >= 2 && fixed_gene_name == "") idx = sam_index_load(sfn, input_file.c_str());
+		for(int i = 0; i < hdr->n_targets; i++) chrms.push_back(hdr->target_name[i]);
+	}
+
 	terminate = false;
 	qlen = 0;
 	qcnt = 0;
+	next_output = 0;
+	nwritten = 0;
 }
 
 assembler::~assembler()
 {
-    bam_destroy1(b1t);
-    bam_hdr_destroy(hdr);
-    sam_close(sfn);
+	if(idx != NULL) hts_idx_destroy(idx);
+	if(hdr != NULL) bam_hdr_destroy(hdr);
+	if(sfn != NULL) sam_close(sfn);
 }
 
 int assembler::assemble()
 {
-    while(sam_read1(sfn, hdr, b1t) >= 0)
+	if(resume_file != "")
 	{
-		if(terminate == true) return 0;
+		if(ckpr.open(resume_file) != 0) return -1;
+		chrms = ckpr.chrms;
+	}
+
+	if(checkpoint_file != "" && ckpt.open(checkpoint_file, chrms) != 0) return -1;
+
+	if(streaming_output == true)
+	{
+		sout.open(output_file.c_str());
+		vout.open((output_file + ".cov").c_str());
+		vout.precision(17);
+		nbundles.assign(chrms.size(), 0);
+		ndone.assign(chrms.size(), 0);
+		closed.assign(chrms.size(), false);
+	}
+
+	// with multiple threads, the reading threads only decode reads and
+	// build bundles, which are assembled by the workers
+	if(num_threads >= 2 && resume_file == "")
+	{
+		for(int i = 0; i < num_threads; i++) workers.push_back(thread(&assembler::work, this));
+	}
+
+	// the subgraphs of a large bundle are shared with idle helpers
+	if(num_threads >= 2) helpers.start(num_threads - 1);
+
+	if(resume_file != "")
+	{
+		resume();
+	}
+	else if(idx != NULL && hdr->n_targets >= 2)
+	{
+		// bundles never span chromosomes, so with an index each
+		// chromosome can be read independently as a shard
+		next_shard = 0;
+		vector<thread> readers;
+		int m = num_threads < hdr->n_targets ? num_threads : hdr->n_targets;
+		for(int i = 0; i < m; i++) readers.push_back(thread(&assembler::read_shards, this));
+		for(int i = 0; i < m; i++) readers[i].join();
+	}
+	else
+	{
+		read(sfn, NULL, 0);
+	}
+
+	bq.close();
+	for(int i = 0; i < workers.size(); i++) workers[i].join();
+	helpers.stop();
+
+	if(resume_file != "" && ckpr.complete() == false)
+	{
+		printf("error: checkpoint %s is incomplete or corrupted\n", resume_file.c_str());
+		return -1;
+	}
+
+	if(ckpt.active() == true) ckpt.close(qlen, qcnt);
+
+	if(streaming_output == true)
+	{
+		// every chromosome has been written by now
+		stage_timer st(STAGE_OUTPUT);
+		sout.close();
+		vout.close();
+		write_RPKM();
+		return 0;
+	}
+
+	collect();
+
+	if(terminate == true) return 0;
+
+	stage_timer st(STAGE_OUTPUT);
+
+	assign_RPKM();
+
+	{
+		stage_timer sf(STAGE_FILTER);
+		filter ft(trsts);
+		ft.merge_single_exon_transcripts();
+		trsts = ft.trs;
+	}
+
+	write();
+	
+	return 0;
+}
+
+int assembler::read(samFile *fn, hts_itr_t *itr, int shard)
+{
+	bam1_t *b1t = bam_init1();
+	bundle_base bb1;		// +
+	bundle_base bb2;		// -
+	vector<bundle_base> pool;
+	int index = 0;
+	int cnt = 0;
+	double len = 0;
+	int64_t td = 0;			// time of decoding
+	int64_t tp = 0;			// time of parsing
+	int64_t nd = 0;			// number of decoded reads
+
+	// chromosomes [cl, cr) are to be closed by this reader
+	int cl = (itr == NULL) ? 0 : shard;
+	int cr = (itr == NULL) ? hdr->n_targets : shard + 1;
+
+	while(true)
+	{
+		int64_t t0 = prof.active() ? wall_clock() : 0;
+		int r = (itr == NULL) ? sam_read1(fn, hdr, b1t) : sam_itr_next(fn, itr, b1t);
+		if(prof.active()) td += wall_clock() - t0;
+		if(r < 0) break;
+		nd++;
+
+		if(terminate == true) break;
 
 		bam1_core_t &p = b1t->core;
 
@@ -49,31 +178,41 @@ int assembler::assemble()
 		if(p.qual < min_mapping_quality) continue;								// ignore hits with small quality
 		if(p.n_cigar < 1) continue;												// should never happen
 
+		int64_t t1 = prof.active() ? wall_clock() : 0;
 		hit ht(b1t);
 		ht.set_tags(b1t);
 		ht.set_strand();
+		if(prof.active()) tp += wall_clock() - t1;
 		//ht.print();
 
 		//if(ht.nh >= 2 && p.qual < min_mapping_quality) continue;
 		//if(ht.nm > max_edit_distance) continue;
 
-		qlen += ht.qlen;
-		qcnt += 1;
+		len += ht.qlen;
+		cnt += 1;
 
 		// truncate
 		if(ht.tid != bb1.tid || ht.pos > bb1.rpos + min_bundle_gap)
 		{
-			pool.push_back(bb1);
+			pool.push_back(std::move(bb1));
 			bb1.clear();
 		}
 		if(ht.tid != bb2.tid || ht.pos > bb2.rpos + min_bundle_gap)
 		{
-			pool.push_back(bb2);
+			pool.push_back(std::move(bb2));
 			bb2.clear();
 		}
 
 		// process
-		process(batch_bundle_size);
+		process(pool, index, batch_bundle_size);
+
+		// input is sorted, so earlier chromosomes are completely read
+		if(streaming_output == true && ht.tid > cl)
+		{
+			process(pool, index, 0);
+			close(cl, ht.tid);
+			cl = ht.tid;
+		}
 
 		//printf("read strand = %c, xs = %c, ts = %c\n", ht.strand, ht.xs, ht.ts);
 
@@ -90,24 +229,96 @@ int assembler::assemble()
 		if(library_type == UNSTRANDED && ht.xs == '-') bb2.add_hit(ht);
 	}
 
-	pool.push_back(bb1);
-	pool.push_back(bb2);
-	process(0);
+	if(terminate == false)
+	{
+		pool.push_back(std::move(bb1));
+		pool.push_back(std::move(bb2));
+		process(pool, index, 0);
+	}
 
-	assign_RPKM();
+	if(streaming_output == true) close(cl, cr);
 
-	filter ft(trsts);
-	ft.merge_single_exon_transcripts();
-	trsts = ft.trs;
+	bam_destroy1(b1t);
 
-	write();
-	
+	if(prof.active()) prof.add(STAGE_DECODE, td, 0, nd);
+	if(prof.active()) prof.add(STAGE_PARSE, tp, 0, cnt);
+
+	result_lock.lock();
+	qcnt += cnt;
+	qlen += len;
+	result_lock.unlock();
+	return 0;
+}
+
+int assembler::read_shards()
+{
+	samFile *fn = sam_open(input_file.c_str(), "r");
+	if(num_hts_threads >= 1) hts_set_threads(fn, num_hts_threads);
+
+	while(true)
+	{
+		shard_lock.lock();
+		int tid = next_shard++;
+		shard_lock.unlock();
+
+		if(tid >= hdr->n_targets) break;
+
+		hts_itr_t *itr = sam_itr_queryi(idx, tid, 0, INT_MAX);
+		if(itr == NULL && streaming_output == true) close(tid, tid + 1);
+		if(itr == NULL) continue;
+
+		read(fn, itr, tid);
+		hts_itr_destroy(itr);
+	}
+
+	sam_close(fn);
+	return 0;
+}
+
+int assembler::resume()
+{
+	// records are shared by all threads
+	vector<thread> v;
+	for(int i = 1; i < num_threads; i++) v.push_back(thread(&assembler::resume_work, this));
+	resume_work();
+	for(int i = 0; i < v.size(); i++) v[i].join();
+
+	qlen = ckpr.qlen;
+	qcnt = ckpr.qcnt;
+
+	if(streaming_output == true) close(0, chrms.size());
+	return 0;
+}
+
+int assembler::resume_work()
+{
+	int64_t id;
+	while(true)
+	{
+		arena a;
+		arena_scope as(&a);
+
+		splice_graph gr;
+		hyper_set hs;
+		if(ckpr.next(id, gr, hs) == false) break;
+
+		if(streaming_output == true)
+		{
+			result_lock.lock();
+			nbundles[high32(id)]++;
+			result_lock.unlock();
+		}
+
+		vector<transcript> ts;
+		if(terminate == false) assemble(gr, hs, low32(id), ts);
+		store(id, ts);
+	}
 	return 0;
 }
 
-int assembler::process(int n)
+int assembler::process(vector<bundle_base> &pool, int &index, int n)
 {
-	if(pool.size() < n) return 0;
+	if(workers.size() == 0 && pool.size() < n) return 0;
 
 	for(int i = 0; i < pool.size(); i++)
 	{
@@ -118,69 +329,370 @@ int assembler::process(int n)
 		if(bb.hits.size() < min_num_hits_in_bundle) continue;
 		if(bb.tid < 0) continue;
 
-		char buf[1024];
-		strcpy(buf, hdr->target_name[bb.tid]);
-
-		bundle bd(bb);
-
-		bd.chrm = string(buf);
-		bd.build();
-		bd.print(index);
+		if(streaming_output == true)
+		{
+			result_lock.lock();
+			nbundles[bb.tid]++;
+			result_lock.unlock();
+		}
 
-		//if(verbose >= 1) bd.print(index);
+		// bundles are labeled in reading order within each chromosome
+		int64_t id = pack(bb.tid, index);
+		if(workers.size() >= 1) bq.push(id, bb);
+		else if(streaming_output == false) assemble(bb, index, trsts);
+		else
+		{
+			vector<transcript> ts;
+			assemble(bb, index, ts);
+			store(id, ts);
+		}
 
-		assemble(bd.gr, bd.hs);
 		index++;
 	}
 	pool.clear();
 	return 0;
 }
 
-int assembler::assemble(const splice_graph &gr0, const hyper_set &hs0)
+int assembler::work()
 {
-	super_graph sg(gr0, hs0);
-	sg.build();
+	// queued bundles are built ahead while available, so that the
+	// most expensive built one is always decomposed first
+	int64_t id;
+	bundle_base bb;
+	while(true)
+	{
+		bool b = (built.size() < batch_bundle_size && bq.try_pop(id, bb) == true);
+		if(b == false)
+		{
+			bundle_job *j = built.pop();
+			if(j != NULL)
+			{
+				vector<transcript> ts;
+				int64_t k = j->id;
+				finish(j, ts);
+				store(k, ts);
+				continue;
+			}
+		}
 
-	vector<transcript> gv;
-	for(int k = 0; k < sg.subs.size(); k++)
+		if(b == false && bq.pop(id, bb) == false) break;
+
+		if(terminate == true)
+		{
+			vector<transcript> ts;
+			store(id, ts);
+			continue;
+		}
+
+		built.push(prepare(bb, id));
+	}
+	return 0;
+}
+
+int assembler::store(int64_t id, vector<transcript> &ts)
+{
+	result_lock.lock();
+	results[id].swap(ts);
+	if(streaming_output == true)
 	{
-		string gid = "gene." + tostring(index) + "." + tostring(k);
-		if(fixed_gene_name != "" && gid != fixed_gene_name) continue;
+		ndone[high32(id)]++;
+		flush();
+	}
+	result_lock.unlock();
+	return 0;
+}
 
-		if(verbose >= 2 && (k == 0 || fixed_gene_name != "")) sg.print();
+int assembler::close(int l, int r)
+{
+	result_lock.lock();
+	for(int i = l; i < r; i++) closed[i] = true;
+	flush();
+	result_lock.unlock();
+	return 0;
+}
 
-		splice_graph &gr = sg.subs[k];
-		hyper_set &hs = sg.hss[k];
+int assembler::flush()
+{
+	// write chromosomes in header order, each once all of its bundles
+	// are assembled; RPKM needs the total read length, and is written
+	// to a sidecar file at the end
+	while(next_output < closed.size())
+	{
+		int t = next_output;
+		if(closed[t] == false || ndone[t] < nbundles[t]) break;
 
-		gr.gid = gid;
-		scallop sc(gr, hs);
-		sc.assemble();
+		stage_timer st(STAGE_OUTPUT);
+		vector<transcript> ts;
+		map< int64_t, vector<transcript> >::iterator it = results.lower_bound(pack(t, 0));
+		while(it != results.end() && high32(it->first) == t)
+		{
+			if(low32(it->first) != nwritten) relabel(it->second, nwritten);
+			ts.insert(ts.end(), it->second.begin(), it->second.end());
+			results.erase(it++);
+			nwritten++;
+		}
 
-		if(verbose >= 2)
 		{
-			printf("transcripts:\n");
-			for(int i = 0; i < sc.trsts.size(); i++) sc.trsts[i].write(cout);
+			stage_timer sf(STAGE_FILTER);
+			filter ft(ts);
+			ft.merge_single_exon_transcripts();
+			ts.swap(ft.trs);
 		}
 
-		filter ft(sc.trsts);
-		ft.join_single_exon_transcripts();
-		ft.filter_length_coverage();
-		if(ft.trs.size() >= 1) gv.insert(gv.end(), ft.trs.begin(), ft.trs.end());
+		for(int i = 0; i < ts.size(); i++)
+		{
+			transcript &x = ts[i];
+			x.write(sout, false);
+			vout<<x.transcript_id.c_str()<<"\t"<<x.coverage<<endl;
+		}
+		sout.flush();
+
+		next_output++;
+	}
+	return 0;
+}
+
+int assembler::write_RPKM()
+{
+	// second pass over the coverage file
+	string file = output_file + ".cov";
+	ifstream fin(file.c_str());
+	ofstream fout((output_file + ".rpkm").c_str());
+	if(fin.fail() || fout.fail()) return 0;
+
+	double factor = 1e9 / qlen;
+	fout.precision(4);
+	fout<<fixed;
+
+	string id;
+	double cov;
+	while(fin >> id >> cov)
+	{
+		fout<<id.c_str()<<"\t"<<cov * factor<<endl;
+	}
+
+	fin.close();
+	fout.close();
+	remove(file.c_str());
+	return 0;
+}
+
+int assembler::collect()
+{
+	// append transcripts in the order of shards and bundles, and number the
+	// bundles as a linear scan would, to keep output deterministic
+	int k = 0;
+	map< int64_t, vector<transcript> >::iterator it;
+	for(it = results.begin(); it != results.end(); it++, k++)
+	{
+		if(low32(it->first) != k) relabel(it->second, k);
+		trsts.insert(trsts.end(), it->second.begin(), it->second.end());
+	}
+	results.clear();
+	return 0;
+}
+
+int assembler::relabel(vector<transcript> &ts, int id)
+{
+	for(int i = 0; i < ts.size(); i++)
+	{
+		transcript &t = ts[i];
+		string gs = t.gene_id.substr(t.gene_id.rfind('.'));			// ".k" of "gene.index.k"
+		string ss = t.transcript_id.substr(t.gene_id.size());		// ".i" of "gene.index.k.i"
+		t.gene_id = "gene." + tostring(id) + gs;
+		t.transcript_id = t.gene_id + ss;
+	}
+	return 0;
+}
+
+int assembler::assemble(bundle_base &bb, int id, vector<transcript> &ts)
+{
+	bundle_job *j = prepare(bb, pack(bb.tid, id));
+	return finish(j, ts);
+}
+
+bundle_job* assembler::prepare(bundle_base &bb, int64_t id)
+{
+	int64_t w = prof.active() ? wall_clock() : 0;
+	int64_t c = prof.active() ? cpu_clock() : 0;
+
+	// graphs of this bundle are allocated from a private arena,
+	// which is released at once when the bundle is done
+	bundle_job *j = new bundle_job;
+	j->id = id;
+	j->mem = new arena;
+	arena_scope as(j->mem);
+
+	// the hits are taken over from bb
+	j->bd = new bundle(std::move(bb));
+	bundle &bd = *(j->bd);
+
+	bd.chrm = chrms[bd.tid];
+	{
+		stage_timer st(STAGE_BUNDLE);
+		bd.build();
+	}
+
+	if(ckpt.active() == true) ckpt.add(id, bd.gr, bd.hs);
+	bd.print(low32(id));
+
+	//if(verbose >= 1) bd.print(id);
+
+	// hits are not needed any more while waiting
+	j->num_hits = bd.hits.size();
+	vector<hit>().swap(bd.hits);
+
+	j->cost = estimate_cost(bd);
+	j->wall = prof.active() ? wall_clock() - w : 0;
+	j->cpu = prof.active() ? cpu_clock() - c : 0;
+	return j;
+}
+
+double assembler::estimate_cost(bundle &bd)
+{
+	// decomposition visits every edge and hyper-edge in each round,
+	// and the number of rounds grows with the number of paths
+	double e = bd.gr.num_edges();
+	double h = bd.hs.nodes.size();
+	double p = (bd.gr.num_vertices() >= 2) ? bd.gr.compute_num_paths() : 0;
+	return (e + h) * log2(2.0 + p);
+}
+
+int assembler::finish(bundle_job *j, vector<transcript> &ts)
+{
+	int64_t w = prof.active() ? wall_clock() : 0;
+	int64_t c = prof.active() ? cpu_clock() : 0;
+	int n = ts.size();
+
+	bundle &bd = *(j->bd);
+	arena &a = *(j->mem);
+	int nv = bd.gr.num_vertices();
+	int ne = bd.gr.num_edges();
+	int nf = 0;
+	{
+		arena_scope as(&a);
+		nf = assemble(bd.gr, bd.hs, low32(j->id), ts);
+	}
+
+	if(prof.active() == true)
+	{
+		bundle_profile p;
+		p.chrm = bd.chrm;
+		p.lpos = bd.lpos;
+		p.rpos = bd.rpos;
+		p.strand = bd.strand;
+		p.num_hits = j->num_hits;
+		p.num_vertices = nv;
+		p.num_edges = ne;
+		p.num_transcripts = ts.size() - n;
+		p.cost = j->cost;
+		p.num_fallbacks = nf;
+		p.wall = j->wall + wall_clock() - w;
+		p.cpu = j->cpu + cpu_clock() - c;
+		p.num_allocations = a.num_allocations();
+		p.memory = a.capacity();
+		prof.add(p);
+	}
+
+	delete j->bd;
+	delete j->mem;
+	delete j;
+	return 0;
+}
+
+int assembler::assemble(splice_graph &gr0, hyper_set &hs0, int id, vector<transcript> &ts)
+{
+	// the time budget is shared by all subgraphs of the bundle
+	int64_t deadline = 0;
+	if(max_bundle_seconds > 0) deadline = wall_clock() + (int64_t)(max_bundle_seconds * 1e9);
+
+	super_graph sg(std::move(gr0), std::move(hs0));
+	{
+		stage_timer st(STAGE_SUPER_GRAPH);
+		sg.build();
+	}
+
+	// subgraphs are decomposed by the helpers as well, unless
+	// the details are printed, and merged in their order
+	bool serial = (verbose >= 2 || fixed_gene_name != "");
+
+	vector< vector<transcript> > vt(sg.subs.size());
+	vector<int> fb(sg.subs.size(), 0);
+	vector<task> tasks;
+	for(int k = 0; k < sg.subs.size(); k++)
+	{
+		string gid = "gene." + tostring(id) + "." + tostring(k);
+		if(fixed_gene_name != "" && gid != fixed_gene_name) continue;
 
-		if(verbose >= 2)
+		if(verbose >= 2 && (k == 0 || fixed_gene_name != "")) sg.print();
+
+		sg.subs[k].gid = gid;
+
+		if(serial == false)
 		{
-			printf("transcripts after filtering:\n");
-			for(int i = 0; i < ft.trs.size(); i++) ft.trs[i].write(cout);
+			tasks.push_back(bind(&assembler::assemble_subgraph, this, ref(sg.subs[k]), ref(sg.hss[k]), deadline, ref(vt[k]), ref(fb[k])));
+			continue;
 		}
 
+		assemble_subgraph(sg.subs[k], sg.hss[k], deadline, vt[k], fb[k]);
+
 		if(fixed_gene_name != "" && gid == fixed_gene_name) terminate = true;
 		if(terminate == true) return 0;
 	}
 
+	helpers.run(tasks);
+
+	vector<transcript> gv;
+	for(int k = 0; k < vt.size(); k++) gv.insert(gv.end(), vt[k].begin(), vt[k].end());
+
+	stage_timer st(STAGE_FILTER);
 	filter ft(gv);
 	ft.remove_nested_transcripts();
-	if(ft.trs.size() >= 1) trsts.insert(trsts.end(), ft.trs.begin(), ft.trs.end());
+	if(ft.trs.size() >= 1) ts.insert(ts.end(), ft.trs.begin(), ft.trs.end());
+
+	int n = 0;
+	for(int k = 0; k < fb.size(); k++) n += fb[k];
+	return n;
+}
+
+int assembler::assemble_subgraph(splice_graph &gr, hyper_set &hs, int64_t deadline, vector<transcript> &ts, int &fallback)
+{
+	if(dump_graphs != "")
+	{
+		string file = dump_graphs + "/" + gr.chrm + "." + gr.gid;
+		gr.write(file + ".sgr");
+		hs.write(file + ".hs");
+	}
+
+	// a subgraph is moved into the scallop, unless a helper decomposes it,
+	// which copies it into its own arena
+	bool b = (gr.get_arena() == arena::current());
+	scallop sc(b ? std::move(gr) : splice_graph(gr), b ? std::move(hs) : hyper_set(hs));
+	sc.deadline = deadline;
+	sc.max_memory = (size_t)(max_bundle_memory) << 20;
+	{
+		stage_timer st(STAGE_SCALLOP);
+		sc.assemble();
+	}
+	fallback = sc.fallback ? 1 : 0;
 
+	if(verbose >= 2)
+	{
+		printf("transcripts:\n");
+		for(int i = 0; i < sc.trsts.size(); i++) sc.trsts[i].write(cout);
+	}
+
+	stage_timer st(STAGE_FILTER);
+	filter ft(sc.trsts);
+	ft.join_single_exon_transcripts();
+	ft.filter_length_coverage();
+	ts.swap(ft.trs);
+
+	if(verbose >= 2)
+	{
+		printf("transcripts after filtering:\n");
+		for(int i = 0; i < ts.size(); i++) ts[i].write(cout);
+	}
 	return 0;
 }
 
@@ -211,7 +723,8 @@ int assembler::compare(splice_graph &gr, const string &file, const string &texfi
 {
 	if(file == "") return 0;
 
-	genome g(file);
+	genome g;
+	g.read(file, num_threads);
 	if(g.genes.size() <= 0) return 0;
 
 	gtf gg(g.genes[0]);
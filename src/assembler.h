@@ -9,10 +9,17 @@ See LICENSE for licensing.
 
 #include <fstream>
 #include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
 #include "bundle_base.h"
+#include "bundle_queue.h"
 #include "bundle.h"
 #include "transcript.h"
 #include "splice_graph.h"
+#include "checkpoint.h"
+#include "task_pool.h"
 
 using namespace std;
 
@@ -25,23 +32,56 @@ public:
 private:
 	samFile *sfn;
 	bam_hdr_t *hdr;
-	bam1_t *b1t;
-	bundle_base bb1;		// +
-	bundle_base bb2;		// -
-	vector<bundle_base> pool;
+	hts_idx_t *idx;								// index of input, NULL if absent
+	vector<string> chrms;						// chromosome names
 
-	int index;
-	bool terminate;
+	atomic<bool> terminate;
 	int qcnt;
 	double qlen;
 	vector<transcript> trsts;
 
+	bundle_queue bq;							// bundles waiting for workers
+	bundle_heap built;							// built bundles waiting for workers
+	vector<thread> workers;						// assembly workers
+	map< int64_t, vector<transcript> > results;	// transcripts of each (chromosome, bundle)
+	mutex result_lock;							// protect results, qcnt, qlen and streaming
+	int next_shard;								// next chromosome to be read
+	mutex shard_lock;							// protect next_shard
+
+	ofstream sout;								// streaming output of finished chromosomes
+	ofstream vout;								// transcript coverage, for the RPKM sidecar
+	vector<int> nbundles;						// bundles of each chromosome sent to assembly
+	vector<int> ndone;							// bundles of each chromosome assembled
+	vector<bool> closed;						// whether each chromosome is completely read
+	int next_output;							// next chromosome to be written
+	int nwritten;								// number of bundles written
+
+	checkpoint_writer ckpt;						// graphs built from the input
+	checkpoint_reader ckpr;						// graphs to resume from
+	task_pool helpers;							// helpers decomposing subgraphs of a bundle
+
 public:
 	int assemble();
 
 private:
-	int process(int n);
-	int assemble(const splice_graph &gr, const hyper_set &hs);
+	int read(samFile *fn, hts_itr_t *itr, int shard);
+	int read_shards();
+	int resume();
+	int resume_work();
+	int process(vector<bundle_base> &pool, int &index, int n);
+	int work();
+	int store(int64_t id, vector<transcript> &ts);
+	int close(int l, int r);
+	int flush();
+	int write_RPKM();
+	int collect();
+	int relabel(vector<transcript> &ts, int id);
+	int assemble(bundle_base &bb, int id, vector<transcript> &ts);				// take over bb
+	bundle_job* prepare(bundle_base &bb, int64_t id);							// take over bb
+	double estimate_cost(bundle &bd);
+	int finish(bundle_job *j, vector<transcript> &ts);
+	int assemble(splice_graph &gr, hyper_set &hs, int id, vector<transcript> &ts);	// take over gr and hs, return the number of fallbacks
+	int assemble_subgraph(splice_graph &gr, hyper_set &hs, int64_t deadline, vector<transcript> &ts, int &fallback);
 	int assign_RPKM();
 	int write();
 	int compare(splice_graph &gr, const string &ref, const string &tex = "");
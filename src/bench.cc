@@ -0,0 +1,221 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+
+#include "config.h"
+#include "genome.h"
+#include "simulator.h"
+#include "assembler.h"
+#include "profiler.h"
+
+using namespace std;
+
+// scallop-bench: simulate alignments from a reference annotation,
+// assemble them repeatedly, and compare the time of each stage
+// with a stored baseline
+
+string bench_ref;								// reference annotation
+string bench_prefix = "bench";					// prefix of generated files
+string bench_baseline;							// baseline to compare with
+string bench_save;								// file to save this run as a baseline
+int bench_repeat = 3;							// number of runs, the fastest is kept
+int bench_seed = 1;								// seed of the simulation
+double bench_tolerance = 0.1;					// allowed relative slowdown
+
+int print_bench_help()
+{
+	printf("\n");
+	printf("Usage: scallop-bench -r <gtf-file> [options]\n");
+	printf("\n");
+	printf("Options:\n");
+	printf(" %-42s  %s\n", "-o <prefix>",  "prefix of the simulated bam and assembled gtf, default: bench");
+	printf(" %-42s  %s\n", "--depth <float>",  "average read coverage of a transcript, default: 10");
+	printf(" %-42s  %s\n", "--isoforms <integer>",  "maximum number of expressed transcripts of each gene, 0 for all, default: 0");
+	printf(" %-42s  %s\n", "--intron_retention <float>",  "fraction of fragments with a retained intron, default: 0.05");
+	printf(" %-42s  %s\n", "--paired_end <true|false>",  "whether fragments are sequenced at both ends, default: true");
+	printf(" %-42s  %s\n", "--read_length <integer>",  "length of each read, default: 100");
+	printf(" %-42s  %s\n", "--fragment_length <integer>",  "mean length of fragments, default: 300");
+	printf(" %-42s  %s\n", "--seed <integer>",  "seed of the simulation, default: 1");
+	printf(" %-42s  %s\n", "--repeat <integer>",  "number of assembly runs, the fastest of each stage is kept, default: 3");
+	printf(" %-42s  %s\n", "--threads <integer>",  "number of threads used to assemble bundles, default: 1");
+	printf(" %-42s  %s\n", "--baseline <file>",  "compare with the stage times stored in this file");
+	printf(" %-42s  %s\n", "--save_baseline <file>",  "store the stage times of this run to this file");
+	printf(" %-42s  %s\n", "--tolerance <float>",  "relative slowdown reported as a regression, default: 0.1");
+	return 0;
+}
+
+int load_baseline(const string &file, map<string, double> &m)
+{
+	ifstream fin(file.c_str());
+	if(fin.fail()) return -1;
+
+	string s;
+	double t;
+	while(fin >> s)
+	{
+		if(s[0] == '#')
+		{
+			getline(fin, s);
+			continue;
+		}
+		fin >> t;
+		m[s] = t;
+	}
+	return 0;
+}
+
+int main(int argc, const char **argv)
+{
+	double depth = 10;
+	int isoforms = 0;
+	double retention = 0.05;
+	bool paired = true;
+	int read_length = 100;
+	int fragment_length = 300;
+
+	for(int i = 1; i < argc; i++)
+	{
+		string s(argv[i]);
+		if(s == "--help")
+		{
+			print_bench_help();
+			return 0;
+		}
+
+		if(i + 1 >= argc)
+		{
+			printf("error: missing value of %s\n", argv[i]);
+			return 1;
+		}
+
+		string v(argv[++i]);
+		if(s == "-r") bench_ref = v;
+		else if(s == "-o") bench_prefix = v;
+		else if(s == "--depth") depth = atof(v.c_str());
+		else if(s == "--isoforms") isoforms = atoi(v.c_str());
+		else if(s == "--intron_retention") retention = atof(v.c_str());
+		else if(s == "--paired_end") paired = (v == "true");
+		else if(s == "--read_length") read_length = atoi(v.c_str());
+		else if(s == "--fragment_length") fragment_length = atoi(v.c_str());
+		else if(s == "--seed") bench_seed = atoi(v.c_str());
+		else if(s == "--repeat") bench_repeat = atoi(v.c_str());
+		else if(s == "--threads") num_threads = atoi(v.c_str());
+		else if(s == "--baseline") bench_baseline = v;
+		else if(s == "--save_baseline") bench_save = v;
+		else if(s == "--tolerance") bench_tolerance = atof(v.c_str());
+		else
+		{
+			printf("error: unknown option %s\n", s.c_str());
+			return 1;
+		}
+	}
+
+	if(bench_ref == "")
+	{
+		print_bench_help();
+		return 1;
+	}
+
+	if(num_threads < 1) num_threads = 1;
+	if(bench_repeat < 1) bench_repeat = 1;
+
+	// simulate
+	genome gm;
+	gm.read(bench_ref);
+
+	simulator sm(gm);
+	sm.depth = depth;
+	sm.max_isoforms = isoforms;
+	sm.intron_retention = retention;
+	sm.paired_end = paired;
+	sm.read_length = read_length;
+	sm.fragment_length = fragment_length;
+
+	int64_t t0 = wall_clock();
+	sm.simulate(bench_seed);
+	string bam = bench_prefix + ".bam";
+	if(sm.write(bam) != 0) return 1;
+	printf("simulated %lu alignments of %lu genes to %s in %.3lf seconds\n", sm.num_reads(), gm.genes.size(), bam.c_str(), (wall_clock() - t0) * 1e-9);
+
+	// assemble
+	input_file = bam;
+	output_file = bench_prefix + ".gtf";
+	library_type = UNSTRANDED;
+	verbose = 0;
+
+	vector<double> best(NUM_STAGES + 1, -1);
+	for(int k = 0; k < bench_repeat; k++)
+	{
+		prof.clear();
+		prof.start();
+
+		assembler asmb;
+		asmb.assemble();
+
+		double total = prof.elapsed();
+		printf("run %d: %.3lf seconds\n", k + 1, total);
+
+		for(int i = 0; i < NUM_STAGES; i++)
+		{
+			double w = prof.wall_seconds(i);
+			if(best[i] < 0 || w < best[i]) best[i] = w;
+		}
+		if(best[NUM_STAGES] < 0 || total < best[NUM_STAGES]) best[NUM_STAGES] = total;
+	}
+
+	vector<string> names;
+	for(int i = 0; i < NUM_STAGES; i++) names.push_back(stage_name(i));
+	names.push_back("total");
+
+	// compare
+	map<string, double> base;
+	if(bench_baseline != "" && load_baseline(bench_baseline, base) != 0)
+	{
+		printf("error: cannot read baseline %s\n", bench_baseline.c_str());
+		return 1;
+	}
+
+	int regressions = 0;
+	printf("\n%-12s %12s %12s %8s\n", "stage", "seconds", "baseline", "ratio");
+	for(int i = 0; i < names.size(); i++)
+	{
+		printf("%-12s %12.4lf", names[i].c_str(), best[i]);
+		if(base.find(names[i]) == base.end())
+		{
+			printf("\n");
+			continue;
+		}
+
+		double b = base[names[i]];
+		double r = (b > 0) ? best[i] / b : 1.0;
+		bool slow = (best[i] > b * (1 + bench_tolerance) && best[i] - b > 0.01);
+		if(slow == true) regressions++;
+		printf(" %12.4lf %8.3lf%s\n", b, r, slow ? "  regression" : "");
+	}
+
+	if(bench_save != "")
+	{
+		ofstream fout(bench_save.c_str());
+		fout<<"# stage\twall-seconds, scallop-bench "<<version.c_str()<<" on "<<bench_ref.c_str()<<endl;
+		fout.precision(6);
+		fout<<fixed;
+		for(int i = 0; i < names.size(); i++) fout<<names[i].c_str()<<"\t"<<best[i]<<endl;
+		fout.close();
+	}
+
+	if(regressions >= 1)
+	{
+		printf("\n%d stage(s) slower than baseline by more than %.0lf%%\n", regressions, bench_tolerance * 100);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,100 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "bottleneck_path.h"
+#include "csr_graph.h"
+
+#include <cassert>
+#include <cfloat>
+#include <algorithm>
+
+bottleneck_path::bottleneck_path(splice_graph &g)
+	: gr(g)
+{
+	int n = gr.num_vertices();
+	csr_graph cg(gr);
+	order = cg.topological_sort();
+	assert(order.size() == n);
+
+	rank.assign(n, -1);
+	for(int i = 0; i < n; i++) rank[order[i]] = i;
+
+	table.assign(n, -1);
+	back.assign(n, null_edge);
+	dirty.assign(n, false);
+
+	if(n == 0) return;
+	table[0] = DBL_MAX;
+	for(int i = 1; i < n; i++) invalidate(i);
+}
+
+int bottleneck_path::invalidate(int v)
+{
+	if(v == 0 || dirty[v] == true) return 0;
+	dirty[v] = true;
+	pending.push(rank[v]);
+	return 0;
+}
+
+int bottleneck_path::update(int v)
+{
+	// the same choice as compute_maximum_st_path_w, the last
+	// in-edge giving the maximum bottleneck
+	double max_abd = 0;
+	edge_descriptor max_edge = null_edge;
+
+	edge_iterator it1, it2;
+	PEEI pei;
+	for(pei = gr.in_edges(v), it1 = pei.first, it2 = pei.second; it1 != it2; it1++)
+	{
+		int s = (*it1)->source();
+		if(table[s] <= -1) continue;
+		double xw = gr.get_edge_weight(*it1);
+		double ww = xw < table[s] ? xw : table[s];
+		if(ww >= max_abd)
+		{
+			max_abd = ww;
+			max_edge = *it1;
+		}
+	}
+
+	double x = (max_edge == null_edge) ? -1 : max_abd;
+	back[v] = max_edge;
+	if(x == table[v]) return 0;
+	table[v] = x;
+
+	for(pei = gr.out_edges(v), it1 = pei.first, it2 = pei.second; it1 != it2; it1++)
+	{
+		invalidate((*it1)->target());
+	}
+	return 0;
+}
+
+double bottleneck_path::compute(VE &p)
+{
+	p.clear();
+	if(gr.num_vertices() == 0) return -1;
+
+	while(pending.size() >= 1)
+	{
+		int v = order[pending.top()];
+		pending.pop();
+		dirty[v] = false;
+		update(v);
+	}
+
+	int x = gr.num_vertices() - 1;
+	while(true)
+	{
+		edge_descriptor e = back[x];
+		if(e == null_edge) break;
+		p.push_back(e);
+		x = e->source();
+	}
+	reverse(p.begin(), p.end());
+
+	return table[gr.num_vertices() - 1];
+}
@@ -0,0 +1,44 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __BOTTLENECK_PATH_H__
+#define __BOTTLENECK_PATH_H__
+
+#include <vector>
+#include <queue>
+
+#include "splice_graph.h"
+
+using namespace std;
+
+// heaviest (maximum bottleneck) path from the source to the sink of a
+// splice graph whose edges are only reduced or removed; the labels of
+// compute_maximum_path_w are kept in topological order, and after a
+// change only the vertices downstream of it whose labels change are
+// recomputed, giving the same paths as computing from scratch
+class bottleneck_path
+{
+public:
+	bottleneck_path(splice_graph &gr);
+
+private:
+	splice_graph &gr;
+	vector<int> order;						// topological order
+	vector<int> rank;						// position of each vertex in order
+	vector<double> table;					// bottleneck from the source, -1 if unreachable
+	VE back;								// last edge of the heaviest path to each vertex
+	vector<bool> dirty;						// whether to be recomputed
+	priority_queue< int, vector<int>, greater<int> > pending;	// ranks of dirty vertices
+
+public:
+	double compute(VE &p);					// the heaviest path and its bottleneck
+	int invalidate(int v);					// in-edges of v have been changed
+
+private:
+	int update(int v);
+};
+
+#endif
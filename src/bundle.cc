@@ -21,11 +21,19 @@ bundle::bundle(const bundle_base &bb)
 {
 }
 
+bundle::bundle(bundle_base &&bb)
+	: bundle_base(std::move(bb))
+{
+}
+
 bundle::~bundle()
 {}
 
 int bundle::build()
 {
+	mmap.build();
+	imap.build();
+
 	compute_strand();
 
 	check_left_ascending();
@@ -91,82 +99,42 @@ int bundle::check_right_ascending()
 
 int bundle::build_junctions()
 {
-	int min_max_boundary_quality = min_mapping_quality;
-	map< int64_t, vector<int> > m;
+	// (splice position, hit) tuples, grouped by sorting
+	vector<PU64I> m;
 	for(int i = 0; i < hits.size(); i++)
 	{
-		vector<int64_t> v = hits[i].spos;
-		if(v.size() == 0) continue;
-
-		//hits[i].print();
-		for(int k = 0; k < v.size(); k++)
-		{
-			int64_t p = v[k];
-
-			// DEBUG
-			/*
-			int32_t x1 = low32(p);
-			int32_t x2 = high32(p);
-			if(fabs(x1 - 9364768) <= 2 || fabs(x2 - 9364768) <=2)
-			{
-				printf("HIT ");
-				hits[i].print();
-			}
-			*/
-			if(m.find(p) == m.end())
-			{
-				vector<int> hv;
-				hv.push_back(i);
-				m.insert(pair< int64_t, vector<int> >(p, hv));
-			}
-			else
-			{
-				m[p].push_back(i);
-			}
-		}
+		interval_list v = hits[i].spos();
+		for(int k = 0; k < v.size(); k++) m.push_back(PU64I(v[k], i));
 	}
 
-	map< int64_t, vector<int> >::iterator it;
-	for(it = m.begin(); it != m.end(); it++)
-	{
-		vector<int> &v = it->second;
-		if(v.size() < min_splice_boundary_hits) continue;
+	radix_sort(m);
 
-		int32_t p1 = high32(it->first);
-		int32_t p2 = low32(it->first);
+	for(int i = 0, j = 0; i < m.size(); i = j)
+	{
+		j = i + 1;
+		while(j < m.size() && m[j].first == m[i].first) j++;
+		if(j - i < min_splice_boundary_hits) continue;
 
 		int s0 = 0;
 		int s1 = 0;
 		int s2 = 0;
 		int nm = 0;
-		for(int k = 0; k < v.size(); k++)
+		for(int k = i; k < j; k++)
 		{
-			hit &h = hits[v[k]];
+			hit &h = hits[m[k].second];
 			nm += h.nm;
 			if(h.xs == '.') s0++;
 			if(h.xs == '+') s1++;
 			if(h.xs == '-') s2++;
 		}
 
-		//printf("junction: %s:%d-%d (%d, %d, %d) %d\n", chrm.c_str(), p1, p2, s0, s1, s2, s1 < s2 ? s1 : s2);
-
-		junction jc(it->first, v.size());
+		junction jc((int64_t)(m[i].first), j - i);
 		jc.nm = nm;
 		if(s1 == 0 && s2 == 0) jc.strand = '.';
 		else if(s1 >= 1 && s2 >= 1) jc.strand = '.';
 		else if(s1 > s2) jc.strand = '+';
 		else jc.strand = '-';
 		junctions.push_back(jc);
-
-		/*
-		uint32_t max_qual = 0;
-		for(int k = 0; k < v.size(); k++)
-		{
-			hit &h = hits[v[k]];
-			if(h.qual > max_qual) max_qual = h.qual;
-		}
-		assert(max_qual >= min_max_boundary_quality);
-		*/
 	}
 	return 0;
 }
@@ -195,11 +163,11 @@ int bundle::correct_junctions()
 			// correct nm2 to nm1
 			fb.insert(k);
 
-			if(j1.lpos < j2.lpos) mmap += make_pair(ROI(j1.lpos + 1, j2.lpos + 1), -1);
-			else if(j1.lpos > j2.lpos) mmap += make_pair(ROI(j2.lpos + 1, j1.lpos + 1), 1);
+			if(j1.lpos < j2.lpos) mmap.add(j1.lpos + 1, j2.lpos + 1, -1);
+			else if(j1.lpos > j2.lpos) mmap.add(j2.lpos + 1, j1.lpos + 1, 1);
 
-			if(j1.rpos < j2.rpos) mmap += make_pair(ROI(j1.rpos, j2.rpos), 1);
-			else if(j1.rpos > j2.rpos) mmap += make_pair(ROI(j2.rpos, j1.rpos), -1);
+			if(j1.rpos < j2.rpos) mmap.add(j1.rpos, j2.rpos, 1);
+			else if(j1.rpos > j2.rpos) mmap.add(j2.rpos, j1.rpos, -1);
 
 			if(verbose >= 2)
 			{
@@ -211,11 +179,11 @@ int bundle::correct_junctions()
 		{
 			// correct nm1 to nm2
 			fb.insert(k - 1);
-			if(j2.lpos < j1.lpos) mmap += make_pair(ROI(j2.lpos + 1, j1.lpos + 1), -1);
-			else if(j2.lpos > j1.lpos) mmap += make_pair(ROI(j1.lpos + 1, j2.lpos + 1), 1);
+			if(j2.lpos < j1.lpos) mmap.add(j2.lpos + 1, j1.lpos + 1, -1);
+			else if(j2.lpos > j1.lpos) mmap.add(j1.lpos + 1, j2.lpos + 1, 1);
 
-			if(j2.rpos < j1.rpos) mmap += make_pair(ROI(j2.rpos, j1.rpos), 1);
-			else if(j2.rpos > j1.rpos) mmap += make_pair(ROI(j1.rpos, j2.rpos), -1);
+			if(j2.rpos < j1.rpos) mmap.add(j2.rpos, j1.rpos, 1);
+			else if(j2.rpos > j1.rpos) mmap.add(j1.rpos, j2.rpos, -1);
 
 			if(verbose >= 2)
 			{
@@ -225,6 +193,8 @@ int bundle::correct_junctions()
 		}
 	}
 
+	mmap.build();
+
 	vector<junction> v;
 	for(int i = 0; i < junctions.size(); i++)
 	{
@@ -344,8 +314,13 @@ int bundle::locate_right_partial_exon(int32_t x)
 
 int bundle::build_hyper_edges2()
 {
-	//sort(hits.begin(), hits.end(), hit_compare_by_name);
-	sort(hits.begin(), hits.end());
+	// order hits by (name hash, hi, position) without moving them;
+	// hits are already ascending by position, and both passes are stable
+	vector<PU64I> o(hits.size());
+	for(int i = 0; i < hits.size(); i++) o[i] = PU64I((uint32_t)(hits[i].hi + 1), i);
+	radix_sort(o);
+	for(int i = 0; i < o.size(); i++) o[i].first = hits[o[i].second].qhash;
+	radix_sort(o);
 
 	/*
 	printf("----------------------\n");
@@ -355,12 +330,12 @@ int bundle::build_hyper_edges2()
 
 	hs.clear();
 
-	string qname;
+	uint64_t qhash = 0;
 	int hi = -2;
 	vector<int> sp1;
-	for(int i = 0; i < hits.size(); i++)
+	for(int i = 0; i < o.size(); i++)
 	{
-		hit &h = hits[i];
+		hit &h = hits[o[i].second];
 		
 		/*
 		printf("sp1 = ( ");
@@ -369,23 +344,24 @@ int bundle::build_hyper_edges2()
 		h.print();
 		*/
 
-		if(h.qname != qname || h.hi != hi)
+		if(h.qhash != qhash || h.hi != hi)
 		{
 			set<int> s(sp1.begin(), sp1.end());
 			if(s.size() >= 2) hs.add_node_list(s);
 			sp1.clear();
 		}
 
-		qname = h.qname;
+		qhash = h.qhash;
 		hi = h.hi;
 
 		if((h.flag & 0x4) >= 1) continue;
 
 		vector<int> sp2;
-		for(int k = 0; k < h.itvm.size(); k++)
+		interval_list v = h.itvm();
+		for(int k = 0; k < v.size(); k++)
 		{
-			int32_t p1 = high32(h.itvm[k]);
-			int32_t p2 = low32(h.itvm[k]);
+			int32_t p1 = high32(v[k]);
+			int32_t p2 = low32(v[k]);
 
 			int k1 = locate_left_partial_exon(p1);
 			int k2 = locate_right_partial_exon(p2);
@@ -745,9 +721,16 @@ bool bundle::extend_boundaries()
 	return false;
 }
 
+typedef pair<double, edge_descriptor> PDE;
+
+bool compare_weighted_edge(const PDE &x, const PDE &y)
+{
+	if(x.first != y.first) return x.first < y.first;
+	return less<edge_descriptor>()(x.second, y.second);
+}
+
 VE bundle::compute_maximal_edges()
 {
-	typedef pair<double, edge_descriptor> PDE;
 	vector<PDE> ve;
 
 	undirected_graph ug;
@@ -768,7 +751,7 @@ VE bundle::compute_maximal_edges()
 
 	vector<int> vv = ug.assign_connected_components();
 
-	sort(ve.begin(), ve.end());
+	sort(ve.begin(), ve.end(), compare_weighted_edge);
 
 	for(int i = 1; i < ve.size(); i++) assert(ve[i - 1].first <= ve[i].first);
 
@@ -24,6 +24,7 @@ class bundle : public bundle_base
 {
 public:
 	bundle(const bundle_base &bb);
+	bundle(bundle_base &&bb);
 	virtual ~bundle();
 
 public:
@@ -20,9 +20,49 @@ bundle_base::bundle_base()
 	strand = '.';
 }
 
+bundle_base::bundle_base(const bundle_base &bb)
+{
+	*this = bb;
+}
+
+bundle_base::bundle_base(bundle_base &&bb) noexcept
+{
+	*this = std::move(bb);
+}
+
 bundle_base::~bundle_base()
 {}
 
+bundle_base& bundle_base::operator=(const bundle_base &bb)
+{
+	if(this == &bb) return *this;
+	tid = bb.tid;
+	chrm = bb.chrm;
+	lpos = bb.lpos;
+	rpos = bb.rpos;
+	strand = bb.strand;
+	hits = bb.hits;
+	mmap = bb.mmap;
+	imap = bb.imap;
+	return *this;
+}
+
+bundle_base& bundle_base::operator=(bundle_base &&bb) noexcept
+{
+	// hits and maps are taken over, leaving bb empty
+	if(this == &bb) return *this;
+	tid = bb.tid;
+	chrm = std::move(bb.chrm);
+	lpos = bb.lpos;
+	rpos = bb.rpos;
+	strand = bb.strand;
+	hits = std::move(bb.hits);
+	mmap = std::move(bb.mmap);
+	imap = std::move(bb.imap);
+	bb.clear();
+	return *this;
+}
+
 int bundle_base::add_hit(const hit &ht)
 {
 	// store new hit
@@ -48,26 +88,29 @@ int bundle_base::add_hit(const hit &ht)
 	}
 	*/
 
-	for(int k = 0; k < ht.itvm.size(); k++)
+	interval_list mv = ht.itvm();
+	for(int k = 0; k < mv.size(); k++)
 	{
-		int32_t s = high32(ht.itvm[k]);
-		int32_t t = low32(ht.itvm[k]);
+		int32_t s = high32(mv[k]);
+		int32_t t = low32(mv[k]);
 		//printf(" add interval %d-%d\n", s, t);
-		mmap += make_pair(ROI(s, t), 1);
+		mmap.add(s, t, 1);
 	}
 
-	for(int k = 0; k < ht.itvi.size(); k++)
+	interval_list iv = ht.itvi();
+	for(int k = 0; k < iv.size(); k++)
 	{
-		int32_t s = high32(ht.itvi[k]);
-		int32_t t = low32(ht.itvi[k]);
-		imap += make_pair(ROI(s, t), 1);
+		int32_t s = high32(iv[k]);
+		int32_t t = low32(iv[k]);
+		imap.add(s, t, 1);
 	}
 
-	for(int k = 0; k < ht.itvd.size(); k++)
+	interval_list dv = ht.itvd();
+	for(int k = 0; k < dv.size(); k++)
 	{
-		int32_t s = high32(ht.itvd[k]);
-		int32_t t = low32(ht.itvd[k]);
-		imap += make_pair(ROI(s, t), 1);
+		int32_t s = high32(dv[k]);
+		int32_t t = low32(dv[k]);
+		imap.add(s, t, 1);
 	}
 
 	return 0;
@@ -75,8 +118,8 @@ int bundle_base::add_hit(const hit &ht)
 
 bool bundle_base::overlap(const hit &ht) const
 {
-	if(mmap.find(ROI(ht.pos, ht.pos + 1)) != mmap.end()) return true;
-	if(mmap.find(ROI(ht.rpos - 1, ht.rpos)) != mmap.end()) return true;
+	if(mmap.find(ht.pos) != mmap.end()) return true;
+	if(mmap.find(ht.rpos - 1) != mmap.end()) return true;
 	return false;
 }
 
@@ -13,7 +13,7 @@ See LICENSE for licensing.
 #include <vector>
 
 #include "hit.h"
-#include "interval_map.h"
+#include "coverage_map.h"
 
 using namespace std;
 
@@ -21,7 +21,11 @@ class bundle_base
 {
 public:
 	bundle_base();
+	bundle_base(const bundle_base &bb);
+	bundle_base(bundle_base &&bb) noexcept;
 	virtual ~bundle_base();
+	bundle_base& operator=(const bundle_base &bb);
+	bundle_base& operator=(bundle_base &&bb) noexcept;
 
 public:
 	int32_t tid;					// chromosome ID
@@ -30,8 +34,8 @@ public:
 	int32_t rpos;					// the rightmost boundary on reference
 	char strand;					// strandness
 	vector<hit> hits;				// hits
-	split_interval_map mmap;		// matched interval map
-	split_interval_map imap;		// indel interval map
+	coverage_map mmap;				// matched interval map
+	coverage_map imap;				// indel interval map
 
 public:
 	int add_hit(const hit &ht);
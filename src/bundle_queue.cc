@@ -0,0 +1,99 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include <cassert>
+#include <algorithm>
+
+#include "bundle_queue.h"
+
+bundle_queue::bundle_queue(int c)
+	: capacity(c), closed(false)
+{
+	if(capacity < 1) capacity = 1;
+}
+
+int bundle_queue::push(int64_t id, bundle_base &bb)
+{
+	unique_lock<mutex> lk(lock);
+	while(q.size() >= capacity) not_full.wait(lk);
+	assert(closed == false);
+	q.push_back(PIB(id, bundle_base()));
+	q.back().second = std::move(bb);
+	lk.unlock();
+	not_empty.notify_one();
+	return 0;
+}
+
+bool bundle_queue::pop(int64_t &id, bundle_base &bb)
+{
+	unique_lock<mutex> lk(lock);
+	while(q.size() == 0 && closed == false) not_empty.wait(lk);
+	if(q.size() == 0) return false;
+	id = q.front().first;
+	bb = std::move(q.front().second);
+	q.pop_front();
+	lk.unlock();
+	not_full.notify_one();
+	return true;
+}
+
+bool bundle_queue::try_pop(int64_t &id, bundle_base &bb)
+{
+	unique_lock<mutex> lk(lock);
+	if(q.size() == 0) return false;
+	id = q.front().first;
+	bb = std::move(q.front().second);
+	q.pop_front();
+	lk.unlock();
+	not_full.notify_one();
+	return true;
+}
+
+int bundle_queue::close()
+{
+	unique_lock<mutex> lk(lock);
+	closed = true;
+	lk.unlock();
+	not_empty.notify_all();
+	return 0;
+}
+
+static bool cheaper(const bundle_job *x, const bundle_job *y)
+{
+	if(x->cost != y->cost) return x->cost < y->cost;
+	return x->id > y->id;
+}
+
+int bundle_heap::push(bundle_job *j)
+{
+	lock.lock();
+	h.push_back(j);
+	push_heap(h.begin(), h.end(), cheaper);
+	lock.unlock();
+	return 0;
+}
+
+bundle_job* bundle_heap::pop()
+{
+	bundle_job *j = NULL;
+	lock.lock();
+	if(h.size() >= 1)
+	{
+		pop_heap(h.begin(), h.end(), cheaper);
+		j = h.back();
+		h.pop_back();
+	}
+	lock.unlock();
+	return j;
+}
+
+int bundle_heap::size()
+{
+	lock.lock();
+	int n = h.size();
+	lock.unlock();
+	return n;
+}
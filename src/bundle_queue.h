@@ -0,0 +1,69 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __BUNDLE_QUEUE_H__
+#define __BUNDLE_QUEUE_H__
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+#include "bundle_base.h"
+#include "bundle.h"
+#include "arena.h"
+
+using namespace std;
+
+typedef pair<int64_t, bundle_base> PIB;
+
+// bounded queue passing bundles from the reader to the assembly workers
+class bundle_queue
+{
+public:
+	bundle_queue(int capacity);
+
+private:
+	int capacity;					// maximum number of queued bundles
+	bool closed;					// no more bundles will be pushed
+	deque<PIB> q;					// queued bundles with their indices
+	mutex lock;
+	condition_variable not_empty;
+	condition_variable not_full;
+
+public:
+	int push(int64_t id, bundle_base &bb);		// block while full, take over bb
+	bool pop(int64_t &id, bundle_base &bb);		// block while empty, false if closed
+	bool try_pop(int64_t &id, bundle_base &bb);	// false if empty
+	int close();
+};
+
+// a bundle whose graphs are built, waiting to be decomposed
+class bundle_job
+{
+public:
+	int64_t id;						// pack(tid, index)
+	double cost;					// estimated cost of decomposition
+	arena *mem;						// arena of the graphs of bd
+	bundle *bd;						// built bundle, without its hits
+	int num_hits;					// number of hits of the bundle
+	int64_t wall;					// wall time of building, in nanoseconds
+	int64_t cpu;					// cpu time of building, in nanoseconds
+};
+
+// built bundles shared by the workers, most expensive first
+class bundle_heap
+{
+private:
+	vector<bundle_job*> h;			// max-heap by cost
+	mutex lock;
+
+public:
+	int push(bundle_job *j);
+	bundle_job *pop();				// NULL if empty
+	int size();
+};
+
+#endif
@@ -0,0 +1,178 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "checkpoint.h"
+#include "binary_io.h"
+
+#include <cstdio>
+#include <cstring>
+
+checkpoint_writer::checkpoint_writer()
+{}
+
+checkpoint_writer::~checkpoint_writer()
+{
+	if(fout.is_open()) fout.close();
+}
+
+int checkpoint_writer::open(const string &file, const vector<string> &chrms)
+{
+	fout.open(file.c_str(), ios::binary);
+	if(fout.fail())
+	{
+		printf("error: cannot write checkpoint %s\n", file.c_str());
+		return -1;
+	}
+
+	binary_writer w;
+	w.data.append(CHECKPOINT_MAGIC, 8);
+	w.put((uint32_t)(CHECKPOINT_VERSION));
+	w.put((uint32_t)(chrms.size()));
+	for(int i = 0; i < chrms.size(); i++) w.put(chrms[i]);
+	fout.write(w.data.data(), w.data.size());
+	return 0;
+}
+
+bool checkpoint_writer::active() const
+{
+	return fout.is_open();
+}
+
+int checkpoint_writer::add(int64_t id, const splice_graph &gr, const hyper_set &hs)
+{
+	// serialized by the calling thread, written under the lock
+	binary_writer w;
+	w.put(id);
+	gr.serialize(w);
+	hs.serialize(w);
+	return write(CHECKPOINT_BUNDLE, w.data);
+}
+
+int checkpoint_writer::close(double qlen, int qcnt)
+{
+	if(fout.is_open() == false) return 0;
+
+	binary_writer w;
+	w.put(qlen);
+	w.put((int64_t)(qcnt));
+	write(CHECKPOINT_END, w.data);
+	fout.close();
+	return 0;
+}
+
+int checkpoint_writer::write(uint8_t tag, const string &data)
+{
+	uint64_t n = data.size();
+	lock.lock();
+	fout.write((const char*)(&tag), sizeof(tag));
+	fout.write((const char*)(&n), sizeof(n));
+	fout.write(data.data(), data.size());
+	lock.unlock();
+	return 0;
+}
+
+checkpoint_reader::checkpoint_reader()
+{
+	finished = false;
+	corrupted = false;
+	qlen = 0;
+	qcnt = 0;
+}
+
+int checkpoint_reader::open(const string &file)
+{
+	fin.open(file.c_str(), ios::binary);
+	if(fin.fail())
+	{
+		printf("error: cannot open checkpoint %s\n", file.c_str());
+		return -1;
+	}
+
+	char magic[8];
+	uint32_t version = 0;
+	uint32_t n = 0;
+	fin.read(magic, 8);
+	fin.read((char*)(&version), sizeof(version));
+	if(fin.fail() || memcmp(magic, CHECKPOINT_MAGIC, 8) != 0)
+	{
+		printf("error: %s is not a checkpoint\n", file.c_str());
+		return -1;
+	}
+	if(version != CHECKPOINT_VERSION)
+	{
+		printf("error: checkpoint %s has version %u, expecting %d\n", file.c_str(), version, CHECKPOINT_VERSION);
+		return -1;
+	}
+
+	fin.read((char*)(&n), sizeof(n));
+	chrms.clear();
+	for(int i = 0; i < n && fin.good(); i++)
+	{
+		uint32_t k = 0;
+		fin.read((char*)(&k), sizeof(k));
+		string s(k, '\0');
+		if(k >= 1) fin.read(&s[0], k);
+		chrms.push_back(s);
+	}
+
+	if(fin.fail())
+	{
+		printf("error: checkpoint %s is truncated\n", file.c_str());
+		return -1;
+	}
+	return 0;
+}
+
+bool checkpoint_reader::next(int64_t &id, splice_graph &gr, hyper_set &hs)
+{
+	uint8_t tag = 0;
+	uint64_t n = 0;
+	string data;
+
+	// records are read under the lock, and decoded by the calling thread
+	lock.lock();
+	if(finished == false && corrupted == false)
+	{
+		fin.read((char*)(&tag), sizeof(tag));
+		fin.read((char*)(&n), sizeof(n));
+		if(fin.good())
+		{
+			data.resize(n);
+			if(n >= 1) fin.read(&data[0], n);
+		}
+		if(fin.fail()) tag = 0;
+	}
+
+	if(tag == CHECKPOINT_END)
+	{
+		binary_reader r(data.data(), data.size());
+		int64_t c;
+		r.get(qlen);
+		r.get(c);
+		qcnt = c;
+		finished = r.done();
+	}
+	lock.unlock();
+
+	if(tag != CHECKPOINT_BUNDLE) return false;
+
+	binary_reader r(data.data(), data.size());
+	r.get(id);
+	if(gr.deserialize(r) != 0 || hs.deserialize(r) != 0 || r.done() == false)
+	{
+		printf("error: corrupted bundle record in checkpoint\n");
+		lock.lock();
+		corrupted = true;
+		lock.unlock();
+		return false;
+	}
+	return true;
+}
+
+bool checkpoint_reader::complete() const
+{
+	return (finished == true && corrupted == false);
+}
@@ -0,0 +1,73 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+
+#include "splice_graph.h"
+#include "hyper_set.h"
+
+using namespace std;
+
+#define CHECKPOINT_MAGIC "SCALLOPK"
+#define CHECKPOINT_VERSION 1
+
+#define CHECKPOINT_BUNDLE 1				// record of a splice graph and its hyper-set
+#define CHECKPOINT_END 2				// record of read statistics, the last one
+
+// binary checkpoint of the splice graphs and hyper-sets built from
+// the alignments: a header with magic, version and chromosome names,
+// followed by records of (tag, size, payload); bundles may appear in
+// any order, and are identified by pack(tid, index)
+class checkpoint_writer
+{
+public:
+	checkpoint_writer();
+	~checkpoint_writer();
+
+private:
+	ofstream fout;
+	mutex lock;						// protect fout
+
+public:
+	int open(const string &file, const vector<string> &chrms);
+	int add(int64_t id, const splice_graph &gr, const hyper_set &hs);
+	int close(double qlen, int qcnt);
+	bool active() const;
+
+private:
+	int write(uint8_t tag, const string &data);
+};
+
+class checkpoint_reader
+{
+public:
+	checkpoint_reader();
+
+private:
+	ifstream fin;
+	mutex lock;						// protect fin
+	bool finished;					// whether the end record has been read
+	bool corrupted;					// whether a record failed to decode
+
+public:
+	vector<string> chrms;			// chromosome names
+	double qlen;					// total length of reads
+	int qcnt;						// number of reads
+
+public:
+	int open(const string &file);
+	bool next(int64_t &id, splice_graph &gr, hyper_set &hs);
+	bool complete() const;
+};
+
+#endif
@@ -53,6 +53,8 @@ int min_transcript_length_base = 150;
 int min_transcript_length_increase = 50;
 int min_exon_length = 20;
 int max_num_exons = 1000;
+double max_bundle_seconds = 0;
+int max_bundle_memory = 0;
 
 // for subsetsum and router
 int max_dp_table_size = 10000;
@@ -75,6 +77,14 @@ string output_file;
 bool output_tex_files = false;
 string fixed_gene_name = "";
 int batch_bundle_size = 100;
+int num_threads = 1;
+int num_hts_threads = 0;
+bool streaming_output = false;
+string profile_file = "";
+string dump_graphs = "";
+int bench_repeat = 5;
+string checkpoint_file = "";
+string resume_file = "";
 int verbose = 1;
 string version = "v0.10.4";
 
@@ -264,6 +274,16 @@ int parse_arguments(int argc, const char ** argv)
 			max_num_exons = atoi(argv[i + 1]);
 			i++;
 		}
+		else if(string(argv[i]) == "--max_bundle_seconds")
+		{
+			max_bundle_seconds = atof(argv[i + 1]);
+			i++;
+		}
+		else if(string(argv[i]) == "--max_bundle_memory")
+		{
+			max_bundle_memory = atoi(argv[i + 1]);
+			i++;
+		}
 		else if(string(argv[i]) == "--max_dp_table_size")
 		{
 			max_dp_table_size = atoi(argv[i + 1]);
@@ -342,15 +362,60 @@ int parse_arguments(int argc, const char ** argv)
 			batch_bundle_size = atoi(argv[i + 1]);
 			i++;
 		}
+		else if(string(argv[i]) == "--threads")
+		{
+			num_threads = atoi(argv[i + 1]);
+			i++;
+		}
+		else if(string(argv[i]) == "--hts_threads")
+		{
+			num_hts_threads = atoi(argv[i + 1]);
+			i++;
+		}
+		else if(string(argv[i]) == "--streaming_output")
+		{
+			string s(argv[i + 1]);
+			if(s == "true") streaming_output = true;
+			else streaming_output = false;
+			i++;
+		}
+		else if(string(argv[i]) == "--profile")
+		{
+			profile_file = string(argv[i + 1]);
+			i++;
+		}
+		else if(string(argv[i]) == "--dump_graphs")
+		{
+			dump_graphs = string(argv[i + 1]);
+			i++;
+		}
+		else if(string(argv[i]) == "--bench_repeat")
+		{
+			bench_repeat = atoi(argv[i + 1]);
+			i++;
+		}
+		else if(string(argv[i]) == "--checkpoint")
+		{
+			checkpoint_file = string(argv[i + 1]);
+			i++;
+		}
+		else if(string(argv[i]) == "--resume")
+		{
+			resume_file = string(argv[i + 1]);
+			i++;
+		}
 	}
 
+	if(num_threads < 1) num_threads = 1;
+	if(bench_repeat < 1) bench_repeat = 1;
+
 	if(min_surviving_edge_weight < 0.1 + min_transcript_coverage) 
 	{
 		min_surviving_edge_weight = 0.1 + min_transcript_coverage;
 	}
 
 	// verify arguments
-	if(input_file == "")
+	if(input_file == "" && resume_file == "")
 	{
 		printf("error: input-file is missing.\n");
 		exit(0);
@@ -400,6 +465,8 @@ int print_parameters()
 	printf("min_transcript_length_base = %d\n", min_transcript_length_base);
 	printf("min_transcript_length_increase = %d\n", min_transcript_length_increase);
 	printf("max_num_exons = %d\n", max_num_exons);
+	printf("max_bundle_seconds = %.2lf\n", max_bundle_seconds);
+	printf("max_bundle_memory = %d\n", max_bundle_memory);
 
 	// for subsetsum and router
 	printf("max_dp_table_size = %d\n", max_dp_table_size);
@@ -426,6 +493,14 @@ int print_parameters()
 	printf("uniquely_mapped_only = %c\n", uniquely_mapped_only ? 'T' : 'F');
 	printf("verbose = %d\n", verbose);
 	printf("batch_bundle_size = %d\n", batch_bundle_size);
+	printf("num_threads = %d\n", num_threads);
+	printf("num_hts_threads = %d\n", num_hts_threads);
+	printf("streaming_output = %c\n", streaming_output ? 'T' : 'F');
+	printf("profile_file = %s\n", profile_file.c_str());
+	printf("dump_graphs = %s\n", dump_graphs.c_str());
+	printf("bench_repeat = %d\n", bench_repeat);
+	printf("checkpoint_file = %s\n", checkpoint_file.c_str());
+	printf("resume_file = %s\n", resume_file.c_str());
 
 	printf("\n");
 
@@ -471,6 +546,15 @@ int print_help()
 	printf(" %-42s  %s\n", "--help",  "print usage of Scallop and exit");
 	printf(" %-42s  %s\n", "--version",  "print current version of Scallop and exit");
 	printf(" %-42s  %s\n", "--verbose <0, 1, 2>",  "0: quiet; 1: one line for each graph; 2: with details, default: 1");
+	printf(" %-42s  %s\n", "--threads <integer>",  "number of threads used to assemble bundles, default: 1");
+	printf(" %-42s  %s\n", "--hts_threads <integer>",  "number of extra threads used to decompress the input, default: 0");
+	printf(" %-42s  %s\n", "--streaming_output <true|false>",  "write each chromosome once it is assembled, RPKM to <output>.rpkm, default: false");
+	printf(" %-42s  %s\n", "--profile <file>",  "write timing and bundle statistics of this run to <file> in JSON");
+	printf(" %-42s  %s\n", "--dump_graphs <dir>",  "write each splice graph and its phasing paths to <dir>, for -a bench");
+	printf(" %-42s  %s\n", "--checkpoint <file>",  "save the splice graphs built from the input to <file>");
+	printf(" %-42s  %s\n", "--resume <file>",  "assemble the splice graphs saved by --checkpoint, without -i");
+	printf(" %-42s  %s\n", "--max_bundle_seconds <float>",  "decompose a bundle greedily once it takes longer, default: 0 (no limit)");
+	printf(" %-42s  %s\n", "--max_bundle_memory <integer>",  "decompose a graph greedily once it takes more MB, default: 0 (no limit)");
 	printf(" %-42s  %s\n", "--library_type <first, second, unstranded>",  "library type of the sample, default: unstranded");
 	printf(" %-42s  %s\n", "--min_transcript_coverage <float>",  "minimum coverage required for a multi-exon transcript, default: 1.01");
 	printf(" %-42s  %s\n", "--min_single_exon_coverage <float>",  "minimum coverage required for a single-exon transcript, default: 20");
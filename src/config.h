@@ -80,6 +80,8 @@ extern int min_transcript_length_base;
 extern int min_transcript_length_increase;
 extern int min_exon_length;
 extern int max_num_exons;
+extern double max_bundle_seconds;
+extern int max_bundle_memory;
 
 // for simulation
 extern int simulation_num_vertices;
@@ -101,6 +103,14 @@ extern int max_num_bundles;
 extern int library_type;
 extern int min_gtf_transcripts_num;
 extern int batch_bundle_size;
+extern int num_threads;
+extern int num_hts_threads;
+extern bool streaming_output;
+extern string profile_file;
+extern string dump_graphs;
+extern int bench_repeat;
+extern string checkpoint_file;
+extern string resume_file;
 extern int verbose;
 extern string version;
 
@@ -0,0 +1,253 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "coverage_map.h"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+int coverage_map::add(int32_t s, int32_t t, int32_t w)
+{
+	if(s >= t) return 0;
+	if(w == 0) return 0;
+	pending.push_back(PROI(ROI(s, t), w));
+	return 0;
+}
+
+int coverage_map::build()
+{
+	if(pending.size() == 0) return 0;
+
+	// existing segments are folded in as weighted intervals
+	pending.insert(pending.end(), segs.begin(), segs.end());
+
+	int32_t l = lower(pending[0].first);
+	int32_t r = upper(pending[0].first);
+	for(int i = 1; i < pending.size(); i++)
+	{
+		if(lower(pending[i].first) < l) l = lower(pending[i].first);
+		if(upper(pending[i].first) > r) r = upper(pending[i].first);
+	}
+
+	// difference array and boundary flags over [l, r]
+	vector<int32_t> d(r - l + 1, 0);
+	vector<bool> b(r - l + 1, false);
+	for(int i = 0; i < pending.size(); i++)
+	{
+		int32_t s = lower(pending[i].first) - l;
+		int32_t t = upper(pending[i].first) - l;
+		d[s] += pending[i].second;
+		d[t] -= pending[i].second;
+		b[s] = true;
+		b[t] = true;
+	}
+
+	segs.clear();
+	int32_t c = 0;
+	int32_t p = -1;
+	for(int32_t i = 0; i < d.size(); i++)
+	{
+		if(b[i] == false) continue;
+		if(p >= 0 && c != 0) segs.push_back(PROI(ROI(l + p, l + i), c));
+		c += d[i];
+		p = i;
+	}
+	assert(c == 0);
+
+	pending.clear();
+	return 0;
+}
+
+int coverage_map::clear()
+{
+	segs.clear();
+	pending.clear();
+	return 0;
+}
+
+static bool upper_lt(const PROI &a, int32_t x)
+{
+	return upper(a.first) < x;
+}
+
+static bool lower_lt(const PROI &a, int32_t x)
+{
+	return lower(a.first) < x;
+}
+
+coverage_map::const_iterator coverage_map::find(int32_t p) const
+{
+	assert(pending.size() == 0);
+	const_iterator it = lower_bound(segs.begin(), segs.end(), p + 1, upper_lt);
+	if(it == segs.end() || lower(it->first) > p) return segs.end();
+	return it;
+}
+
+coverage_map::const_iterator coverage_map::first_after(int32_t x) const
+{
+	assert(pending.size() == 0);
+	return lower_bound(segs.begin(), segs.end(), x, lower_lt);
+}
+
+coverage_map::const_iterator coverage_map::last_before(int32_t x) const
+{
+	assert(pending.size() == 0);
+	const_iterator it = lower_bound(segs.begin(), segs.end(), x + 1, upper_lt);
+	if(it == segs.begin()) return segs.end();
+	return it - 1;
+}
+
+int compute_overlap(const coverage_map &cmap, int32_t p)
+{
+	CMI it = cmap.find(p);
+	if(it == cmap.end()) return 0;
+	return it->second;
+}
+
+CMI locate_right_iterator(const coverage_map &cmap, int32_t x)
+{
+	return cmap.first_after(x);
+}
+
+CMI locate_left_iterator(const coverage_map &cmap, int32_t x)
+{
+	return cmap.last_before(x);
+}
+
+PCMI locate_boundary_iterators(const coverage_map &cmap, int32_t x, int32_t y)
+{
+	CMI lit, rit;
+	lit = locate_right_iterator(cmap, x);
+	if(lit == cmap.end() || upper(lit->first) > y) lit = cmap.end();
+
+	rit = locate_left_iterator(cmap, y);
+	if(rit == cmap.end() || lower(rit->first) < x) rit = cmap.end();
+
+	if(lit == cmap.end()) assert(rit == cmap.end());
+	if(rit == cmap.end()) assert(lit == cmap.end());
+
+	return PCMI(lit, rit);
+}
+
+int compute_coverage(const coverage_map &cmap, CMI &p, CMI &q)
+{
+	if(p == cmap.end()) return 0;
+
+	int32_t s = 0;
+	for(CMI it = p; it != q; it++) s += upper(it->first) - lower(it->first);
+	if(q != cmap.end()) s += upper(q->first) - lower(q->first);
+	return s;
+}
+
+int compute_max_overlap(const coverage_map &cmap, CMI &p, CMI &q)
+{
+	if(p == cmap.end()) return 0;
+
+	int32_t s = 0;
+	for(CMI it = p; it != q; it++)
+	{
+		if(it->second > s) s = it->second;
+	}
+	if(q != cmap.end() && q->second > s) s = q->second;
+	return s;
+}
+
+int compute_sum_overlap(const coverage_map &cmap, CMI &p, CMI &q)
+{
+	if(p == cmap.end()) return 0;
+
+	int32_t s = 0;
+	for(CMI it = p; it != q; it++)
+	{
+		assert(upper(it->first) > lower(it->first));
+		s += (upper(it->first) - lower(it->first)) * it->second;
+	}
+	if(q != cmap.end()) s += (upper(q->first) - lower(q->first)) * q->second;
+	return s;
+}
+
+int evaluate_rectangle(const coverage_map &cmap, int ll, int rr, double &ave, double &dev)
+{
+	ave = 0;
+	dev = 1.0;
+
+	PCMI pei = locate_boundary_iterators(cmap, ll, rr);
+	CMI lit = pei.first, rit = pei.second;
+
+	if(lit == cmap.end()) return 0;
+	if(rit == cmap.end()) return 0;
+
+	ave = 1.0 * compute_sum_overlap(cmap, lit, rit) / (rr - ll);
+
+	double var = 0;
+	for(CMI it = lit; ; it++)
+	{
+		assert(upper(it->first) > lower(it->first));
+		var += (it->second - ave) * (it->second - ave) * (upper(it->first) - lower(it->first));
+		if(it == rit) break;
+	}
+
+	dev = sqrt(var / (rr - ll));
+	return 0;
+}
+
+int evaluate_triangle(const coverage_map &cmap, int ll, int rr, double &ave, double &dev)
+{
+	ave = 0;
+	dev = 1.0;
+
+	PCMI pei = locate_boundary_iterators(cmap, ll, rr);
+	CMI lit = pei.first, rit = pei.second;
+
+	if(lit == cmap.end()) return 0;
+	if(rit == cmap.end()) return 0;
+
+	vector<double> xv;
+	vector<double> yv;
+	double xm = 0;
+	double ym = 0;
+	for(CMI it = lit; ; it++)
+	{
+		double xi = (lower(it->first) + upper(it->first)) / 2.0;
+		double yi = it->second;
+		xv.push_back(xi);
+		yv.push_back(yi);
+		xm += xi;
+		ym += yi;
+		if(it == rit) break;
+	}
+
+	xm /= xv.size();
+	ym /= yv.size();
+
+	double f1 = 0;
+	double f2 = 0;
+	for(int i = 0; i < xv.size(); i++)
+	{
+		f1 += (xv[i] - xm) * (yv[i] - ym);
+		f2 += (xv[i] - xm) * (xv[i] - xm);
+	}
+
+	double b1 = f1 / f2;
+	double b0 = ym - b1 * xm;
+
+	double a1 = b1 * rr + b0;
+	double a0 = b1 * ll + b0;
+	ave = (a1 > a0) ? a1 : a0;
+
+	double var = 0;
+	for(int i = 0; i < xv.size(); i++)
+	{
+		double yi = b1 * xv[i] + b0;
+		CMI it = lit + i;
+		var += (yv[i] - yi) * (yv[i] - yi) * (upper(it->first) - lower(it->first));
+	}
+
+	dev = sqrt(var / (rr - ll));
+	if(dev < 1.0) dev = 1.0;
+
+	return 0;
+}
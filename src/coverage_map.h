@@ -0,0 +1,61 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __COVERAGE_MAP_H__
+#define __COVERAGE_MAP_H__
+
+#include <stdint.h>
+#include <vector>
+
+#include "interval_map.h"
+
+using namespace std;
+
+typedef pair<ROI, int32_t> PROI;
+
+// flat replacement of split_interval_map for read coverage:
+// intervals are recorded by add() and folded into a sorted array
+// of segments by build(), with a difference array over their span;
+// segments are split at every endpoint ever added, and segments
+// with zero coverage are dropped, as in split_interval_map
+class coverage_map
+{
+public:
+	typedef vector<PROI>::const_iterator const_iterator;
+
+private:
+	vector<PROI> segs;				// segments, sorted and disjoint
+	vector<PROI> pending;			// intervals added since last build
+
+public:
+	int add(int32_t s, int32_t t, int32_t w);
+	int build();
+	int clear();
+
+	const_iterator begin() const { return segs.begin(); }
+	const_iterator end() const { return segs.end(); }
+	size_t size() const { return segs.size(); }
+
+	const_iterator find(int32_t p) const;			// segment containing p
+	const_iterator first_after(int32_t x) const;	// first segment with lower >= x
+	const_iterator last_before(int32_t x) const;	// last segment with upper <= x
+};
+
+typedef coverage_map::const_iterator CMI;
+typedef pair<CMI, CMI> PCMI;
+
+// same queries as for split_interval_map
+int compute_overlap(const coverage_map &cmap, int32_t p);
+CMI locate_right_iterator(const coverage_map &cmap, int32_t x);
+CMI locate_left_iterator(const coverage_map &cmap, int32_t x);
+PCMI locate_boundary_iterators(const coverage_map &cmap, int32_t x, int32_t y);
+int compute_coverage(const coverage_map &cmap, CMI &p, CMI &q);
+int compute_max_overlap(const coverage_map &cmap, CMI &p, CMI &q);
+int compute_sum_overlap(const coverage_map &cmap, CMI &p, CMI &q);
+int evaluate_rectangle(const coverage_map &cmap, int ll, int rr, double &ave, double &dev);
+int evaluate_triangle(const coverage_map &cmap, int ll, int rr, double &ave, double &dev);
+
+#endif
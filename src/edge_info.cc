@@ -33,3 +33,26 @@ edge_info::edge_info(const edge_info &ei)
 	weight = ei.weight;
 	strand = ei.strand;
 }
+
+int edge_info::serialize(binary_writer &w) const
+{
+	w.put(stddev);
+	w.put((int32_t)(length));
+	w.put((int32_t)(type));
+	w.put((int32_t)(jid));
+	w.put(weight);
+	w.put(strand);
+	return 0;
+}
+
+int edge_info::deserialize(binary_reader &r)
+{
+	int32_t x;
+	r.get(stddev);
+	r.get(x); length = x;
+	r.get(x); type = x;
+	r.get(x); jid = x;
+	r.get(weight);
+	r.get(strand);
+	return r.fail() ? -1 : 0;
+}
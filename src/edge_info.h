@@ -7,6 +7,9 @@ See LICENSE for licensing.
 #ifndef __EDGE_INFO__
 #define __EDGE_INFO__
 
+#include <stdint.h>
+#include "binary_io.h"
+
 class edge_info
 {
 public:
@@ -21,6 +24,10 @@ public:
 	int jid;		// junction id
 	double weight;	// new weight from hyper-edges
 	char strand;	// strandness
+
+public:
+	int serialize(binary_writer &w) const;
+	int deserialize(binary_reader &r);
 };
 
 #endif
@@ -7,8 +7,11 @@ See LICENSE for licensing.
 #include "filter.h"
 #include "config.h"
 #include <cassert>
+#include <climits>
 #include <algorithm>
 
+typedef pair<double, int> PDI;
+
 filter::filter(const vector<transcript> &v)
 	:trs(v)
 {}
@@ -31,39 +34,81 @@ int filter::filter_length_coverage()
 
 int filter::remove_nested_transcripts()
 {
-	set<int> s;
+	// a multi-exon transcript is removed if some multi-exon transcript with
+	// no smaller coverage lies strictly inside one of its introns;
+	// transcripts are visited by decreasing coverage, with those of no smaller
+	// coverage inserted into a min-tree of right bounds ordered by left bound
+	vector<int> c;
 	for(int i = 0; i < trs.size(); i++)
 	{
-		vector<PI32> v = trs[i].exons;
-		if(v.size() <= 1) continue;
+		if(trs[i].exons.size() <= 1) continue;
+		c.push_back(i);
+	}
+
+	int n = c.size();
+	vector<PI32> bs(trs.size());
+	vector<PPI> lv(n);
+	for(int k = 0; k < n; k++)
+	{
+		bs[c[k]] = trs[c[k]].get_bounds();
+		lv[k] = PPI(bs[c[k]].first, c[k]);
+	}
+	sort(lv.begin(), lv.end());
+
+	vector<int32_t> xs(n);
+	vector<int> rank(trs.size(), -1);
+	for(int k = 0; k < n; k++)
+	{
+		xs[k] = lv[k].first;
+		rank[lv[k].second] = k;
+	}
+
+	vector<PDI> wv(n);
+	for(int k = 0; k < n; k++) wv[k] = PDI(-trs[c[k]].coverage, c[k]);
+	sort(wv.begin(), wv.end());
+
+	vector<int32_t> tree(2 * n, INT_MAX);
+	vector<bool> fb(trs.size(), false);
+	int m = 0;
+	for(int k = 0; k < n; k++)
+	{
+		int i = wv[k].second;
 		double w1 = trs[i].coverage;
-		bool b = false;
-		for(int k = 1; k < v.size(); k++)
+		while(m < n && trs[wv[m].second].coverage >= w1)
 		{
-			int32_t p = v[k - 1].second;
-			int32_t q = v[k - 0].first;
+			int x = wv[m].second;
+			for(int u = rank[x] + n; u >= 1; u /= 2)
+			{
+				if(bs[x].second < tree[u]) tree[u] = bs[x].second;
+			}
+			m++;
+		}
 
-			for(int j = 0; j < trs.size(); j++)
+		const vector<PI32> &v = trs[i].exons;
+		for(int e = 1; e < v.size() && fb[i] == false; e++)
+		{
+			int32_t p = v[e - 1].second;
+			int32_t q = v[e - 0].first;
+
+			// minimum right bound among left bounds in (p, q)
+			int l = upper_bound(xs.begin(), xs.end(), p) - xs.begin() + n;
+			int r = lower_bound(xs.begin(), xs.end(), q) - xs.begin() + n;
+			int32_t b = INT_MAX;
+			for(; l < r; l /= 2, r /= 2)
 			{
-				if(trs[j].exons.size() <= 1) continue;
-				PI32 pq = trs[j].get_bounds();
-				double w2 = trs[j].coverage;
-
-				if(w2 >= w1 && pq.first > p && pq.second < q)
-				{
-					b = true;
-					break;
-				}
+				if(l % 2 == 1 && tree[l] < b) b = tree[l];
+				if(r % 2 == 1 && tree[r - 1] < b) b = tree[r - 1];
+				if(l % 2 == 1) l++;
+				if(r % 2 == 1) r--;
 			}
-			if(b == true) break;
+			if(b < q) fb[i] = true;
 		}
-		if(b == true) s.insert(i);
 	}
 
 	vector<transcript> v;
 	for(int i = 0; i < trs.size(); i++)
 	{
-		if(s.find(i) != s.end()) continue;
+		if(fb[i] == true) continue;
 		v.push_back(trs[i]);
 	}
 
@@ -173,7 +218,7 @@ int filter::merge_single_exon_transcripts(vector<transcript> &trs0)
 	vector<PPI> vv;
 	for(int i = 0; i < trs0.size(); i++)
 	{
-		vector<PI32> v = trs0[i].exons;
+		const vector<PI32> &v = trs0[i].exons;
 		for(int k = 0; k < v.size(); k++)
 		{
 			vv.push_back(PPI(v[k], i));
@@ -182,7 +227,7 @@ int filter::merge_single_exon_transcripts(vector<transcript> &trs0)
 
 	sort(vv.begin(), vv.end());
 
-	set<int> fb;
+	vector<bool> fb(trs0.size(), false);
 	for(int i = 0; i < vv.size(); i++)
 	{
 		int32_t p1 = vv[i].first.first;
@@ -198,7 +243,7 @@ int filter::merge_single_exon_transcripts(vector<transcript> &trs0)
 			int32_t p2 = vv[k].first.first;
 			int32_t q2 = vv[k].first.second;
 			int k2 = vv[k].second;
-			if(fb.find(k2) != fb.end()) continue;
+			if(fb[k2] == true) continue;
 			transcript &t2 = trs0[k2];
 			if(t2.seqname != t1.seqname) continue;
 
@@ -211,7 +256,7 @@ int filter::merge_single_exon_transcripts(vector<transcript> &trs0)
 			break;
 		}
 
-		if(b == true) fb.insert(k1);
+		if(b == true) fb[k1] = true;
 		if(b == true) continue;
 
 		for(int k = i + 1; k < vv.size(); k++)
@@ -219,7 +264,7 @@ int filter::merge_single_exon_transcripts(vector<transcript> &trs0)
 			int32_t p2 = vv[k].first.first;
 			int32_t q2 = vv[k].first.second;
 			int k2 = vv[k].second;
-			if(fb.find(k2) != fb.end()) continue;
+			if(fb[k2] == true) continue;
 			transcript &t2 = trs0[k2];
 			if(t2.seqname != t1.seqname) continue;
 
@@ -232,13 +277,13 @@ int filter::merge_single_exon_transcripts(vector<transcript> &trs0)
 
 			break;
 		}
-		if(b == true) fb.insert(k1);
+		if(b == true) fb[k1] = true;
 	}
 
 	vector<transcript> v;
 	for(int i = 0; i < trs0.size(); i++)
 	{
-		if(fb.find(i) != fb.end()) continue;
+		if(fb[i] == true) continue;
 		v.push_back(trs0[i]);
 	}
 	trs0 = v;
@@ -0,0 +1,193 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "graph_bench.h"
+#include "config.h"
+#include "arena.h"
+#include "splice_graph.h"
+#include "hyper_set.h"
+#include "scallop.h"
+#include "profiler.h"
+
+#include <cstdio>
+#include <fstream>
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define GRAPH_BENCH_TOP 20				// number of slowest graphs printed
+
+static bool slower(const graph_timing &x, const graph_timing &y)
+{
+	return x.tmed > y.tmed;
+}
+
+static string suffix_removed(const string &s, const string &x)
+{
+	if(s.size() < x.size() || s.compare(s.size() - x.size(), x.size(), x) != 0) return s;
+	return s.substr(0, s.size() - x.size());
+}
+
+graph_bench::graph_bench(const string &corpus)
+{
+	collect(corpus);
+}
+
+int graph_bench::collect(const string &corpus)
+{
+	files.clear();
+
+	struct stat st;
+	if(stat(corpus.c_str(), &st) != 0)
+	{
+		printf("error: cannot open corpus %s\n", corpus.c_str());
+		return -1;
+	}
+
+	if(S_ISDIR(st.st_mode))
+	{
+		DIR *d = opendir(corpus.c_str());
+		if(d == NULL) return -1;
+		struct dirent *e;
+		while((e = readdir(d)) != NULL)
+		{
+			string s(e->d_name);
+			string t = suffix_removed(s, ".sgr");
+			if(t == s) continue;
+			files.push_back(corpus + "/" + t);
+		}
+		closedir(d);
+	}
+	else
+	{
+		ifstream fin(corpus.c_str());
+		string s;
+		while(getline(fin, s))
+		{
+			if(s == "") continue;
+			files.push_back(suffix_removed(s, ".sgr"));
+		}
+	}
+
+	sort(files.begin(), files.end());
+	return 0;
+}
+
+int graph_bench::run()
+{
+	timings.clear();
+	for(int i = 0; i < files.size(); i++)
+	{
+		graph_timing gt;
+		if(run(files[i], gt) != 0) continue;
+		timings.push_back(gt);
+	}
+
+	report();
+	if(output_file != "") write(output_file);
+	return 0;
+}
+
+int graph_bench::run(const string &name, graph_timing &gt)
+{
+	splice_graph gr;
+	gr.build(name + ".sgr");
+	if(gr.num_vertices() == 0) return -1;
+
+	// a missing hyper-set means no phasing paths
+	hyper_set hs;
+	hs.read(name + ".hs");
+
+	gr.gid = name.substr(name.rfind('/') + 1);
+
+	gt.name = name;
+	gt.num_vertices = gr.num_vertices();
+	gt.num_edges = gr.num_edges();
+	gt.num_phases = hs.nodes.size();
+
+	// decomposition prints at verbose >= 1
+	int v = verbose;
+	verbose = 0;
+
+	vector<double> ti;
+	vector<double> ta;
+	for(int r = 0; r < bench_repeat; r++)
+	{
+		arena a;
+		arena_scope as(&a);
+
+		int64_t t0 = wall_clock();
+		scallop sc(gr, hs);
+		int64_t t1 = wall_clock();
+		sc.assemble();
+		int64_t t2 = wall_clock();
+
+		ti.push_back((t1 - t0) * 1e-9);
+		ta.push_back((t2 - t1) * 1e-9);
+		gt.num_transcripts = sc.trsts.size();
+	}
+
+	verbose = v;
+
+	sort(ti.begin(), ti.end());
+	sort(ta.begin(), ta.end());
+
+	int m = ta.size() / 2;
+	gt.init = ti[m];
+	gt.tmin = ta.front();
+	gt.tmax = ta.back();
+	gt.tmed = (ta.size() % 2 == 1) ? ta[m] : (ta[m - 1] + ta[m]) / 2.0;
+	gt.tmean = 0;
+	for(int i = 0; i < ta.size(); i++) gt.tmean += ta[i];
+	gt.tmean /= ta.size();
+
+	return 0;
+}
+
+int graph_bench::report()
+{
+	double s1 = 0, s2 = 0, s3 = 0;
+	for(int i = 0; i < timings.size(); i++)
+	{
+		s1 += timings[i].init;
+		s2 += timings[i].tmin;
+		s3 += timings[i].tmed;
+	}
+
+	printf("%lu graphs, %d runs each\n", timings.size(), bench_repeat);
+	printf("total: init = %.6lf, assemble min = %.6lf, median = %.6lf seconds\n", s1, s2, s3);
+
+	vector<graph_timing> v = timings;
+	sort(v.begin(), v.end(), slower);
+	if(v.size() > GRAPH_BENCH_TOP) v.resize(GRAPH_BENCH_TOP);
+
+	printf("\n%-40s %8s %8s %8s %12s %12s %12s\n", "slowest graphs", "vertices", "edges", "phases", "init", "median", "max");
+	for(int i = 0; i < v.size(); i++)
+	{
+		const graph_timing &gt = v[i];
+		string s = gt.name.substr(gt.name.rfind('/') + 1);
+		printf("%-40s %8d %8d %8d %12.6lf %12.6lf %12.6lf\n", s.c_str(), gt.num_vertices, gt.num_edges, gt.num_phases, gt.init, gt.tmed, gt.tmax);
+	}
+	return 0;
+}
+
+int graph_bench::write(const string &file)
+{
+	ofstream fout(file.c_str());
+	if(fout.fail()) return -1;
+
+	fout<<"# graph\tvertices\tedges\tphases\ttranscripts\tinit\tmin\tmedian\tmean\tmax"<<endl;
+	fout.precision(6);
+	fout<<fixed;
+	for(int i = 0; i < timings.size(); i++)
+	{
+		const graph_timing &gt = timings[i];
+		fout<<gt.name.c_str()<<"\t"<<gt.num_vertices<<"\t"<<gt.num_edges<<"\t"<<gt.num_phases<<"\t";
+		fout<<gt.num_transcripts<<"\t"<<gt.init<<"\t"<<gt.tmin<<"\t"<<gt.tmed<<"\t"<<gt.tmean<<"\t"<<gt.tmax<<endl;
+	}
+	fout.close();
+	return 0;
+}
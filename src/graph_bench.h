@@ -0,0 +1,53 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __GRAPH_BENCH_H__
+#define __GRAPH_BENCH_H__
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// timing of decomposing one graph
+class graph_timing
+{
+public:
+	string name;					// file of the graph, without suffix
+	int num_vertices;
+	int num_edges;
+	int num_phases;					// number of lists of nodes in hyper-set
+	int num_transcripts;			// transcripts of the last run
+	double init;					// median time to build scallop, in seconds
+	double tmin;					// time of scallop::assemble, in seconds
+	double tmed;
+	double tmean;
+	double tmax;
+};
+
+// run scallop::assemble repeatedly on a corpus of splice graphs and
+// hyper-sets written by --dump_graphs, without reading alignments;
+// the corpus is a directory of .sgr files or a file listing them
+class graph_bench
+{
+public:
+	graph_bench(const string &corpus);
+
+private:
+	vector<string> files;			// graphs, without suffix
+	vector<graph_timing> timings;	// timing of each graph
+
+public:
+	int run();
+
+private:
+	int collect(const string &corpus);
+	int run(const string &name, graph_timing &gt);
+	int report();
+	int write(const string &file);
+};
+
+#endif
@@ -28,55 +28,86 @@ hit::hit(int32_t p)
 }
 */
 
+hit::hit(const hit &h)
+	:bam1_core_t(h)
+{
+	ext = NULL;
+	*this = h;
+}
+
+hit::hit(hit &&h)
+	:bam1_core_t(h)
+{
+	ext = NULL;
+	*this = std::move(h);
+}
+
 hit& hit::operator=(const hit &h)
 {
+	if(this == &h) return *this;
+
 	bam1_core_t::operator=(h);
 	rpos = h.rpos;
 	qlen = h.qlen;
-	qname = h.qname;
+	qhash = h.qhash;
 	strand = h.strand;
-	spos = h.spos;
 	xs = h.xs;
 	ts = h.ts;
+	nh = h.nh;
 	hi = h.hi;
 	nm = h.nm;
-	itvm = h.itvm;
-	itvi = h.itvi;
-	itvd = h.itvd;
+	concordant = h.concordant;
+
+	nspos = h.nspos;
+	nitvm = h.nitvm;
+	nitvi = h.nitvi;
+	nitvd = h.nitvd;
+
+	if(ext != NULL) delete[] ext;
+	ext = NULL;
+
+	int n = nspos + nitvm + nitvi + nitvd;
+	if(h.ext == NULL)
+	{
+		memcpy(buf, h.buf, n * sizeof(int64_t));
+	}
+	else
+	{
+		ext = new int64_t[n];
+		memcpy(ext, h.ext, n * sizeof(int64_t));
+	}
 	return *this;
 }
 
-hit::hit(const hit &h)
-	:bam1_core_t(h)
+hit& hit::operator=(hit &&h)
 {
-	rpos = h.rpos;
-	qlen = h.qlen;
-	qname = h.qname;
-	strand = h.strand;
-	spos = h.spos;
-	xs = h.xs;
-	ts = h.ts;
-	hi = h.hi;
-	nm = h.nm;
-	itvm = h.itvm;
-	itvi = h.itvi;
-	itvd = h.itvd;
+	if(this == &h) return *this;
+
+	int64_t *x = h.ext;
+	h.ext = NULL;
+	*this = h;
+	ext = x;
+	return *this;
 }
 
 hit::~hit()
 {
+	if(ext != NULL) delete[] ext;
 }
 
 hit::hit(bam1_t *b)
 	:bam1_core_t(b->core)
 {
-	// fetch query name
-	char buf[1024];
-	char *qs = bam_get_qname(b);
-	int l = strlen(qs);
-	memcpy(buf, qs, l);
-	buf[l] = '\0';
-	qname = string(buf);
+	concordant = false;
+
+	// hash query name (FNV-1a), mates and multiple alignments
+	// of a read are grouped by this value
+	qhash = 14695981039346656037ull;
+	for(char *qs = bam_get_qname(b); *qs != '\0'; qs++)
+	{
+		qhash ^= (uint8_t)(*qs);
+		qhash *= 1099511628211ull;
+	}
 
 	// compute rpos
 	rpos = pos + (int32_t)bam_cigar2rlen(n_cigar, bam_get_cigar(b));
@@ -87,8 +118,13 @@ hit::hit(bam1_t *b)
 	assert(n_cigar >= 1);
 	uint32_t * cigar = bam_get_cigar(b);
 
+	// each cigar operation produces at most one interval
+	ext = NULL;
+	if(n_cigar > HIT_INLINE_INTERVALS) ext = new int64_t[n_cigar];
+	int64_t *x = (ext == NULL) ? buf : ext;
+
 	// build splice positions
-	spos.clear();
+	nspos = 0;
 	int32_t p = pos;
 	int32_t q = 0;
     for(int k = 0; k < n_cigar; k++)
@@ -107,12 +143,20 @@ hit::hit(bam1_t *b)
 		if(bam_cigar_oplen(cigar[k+1]) < min_flank_length) continue;
 
 		int32_t s = p - bam_cigar_oplen(cigar[k]);
-		spos.push_back(pack(s, p));
+		x[nspos++] = pack(s, p);
 	}
 
-	itvm.clear();
-	itvi.clear();
-	itvd.clear();
+	nitvm = nitvi = nitvd = 0;
+    for(int k = 0; k < n_cigar; k++)
+	{
+		if(bam_cigar_op(cigar[k]) == BAM_CMATCH) nitvm++;
+		if(bam_cigar_op(cigar[k]) == BAM_CINS) nitvi++;
+		if(bam_cigar_op(cigar[k]) == BAM_CDEL) nitvd++;
+	}
+
+	int64_t *xm = x + nspos;
+	int64_t *xi = xm + nitvm;
+	int64_t *xd = xi + nitvi;
 	p = pos;
     for(int k = 0; k < n_cigar; k++)
 	{
@@ -124,24 +168,49 @@ hit::hit(bam1_t *b)
 		if(bam_cigar_op(cigar[k]) == BAM_CMATCH)
 		{
 			int32_t s = p - bam_cigar_oplen(cigar[k]);
-			itvm.push_back(pack(s, p));
+			*(xm++) = pack(s, p);
 		}
 
 		if(bam_cigar_op(cigar[k]) == BAM_CINS)
 		{
-			itvi.push_back(pack(p - 1, p + 1));
+			*(xi++) = pack(p - 1, p + 1);
 		}
 
 		if(bam_cigar_op(cigar[k]) == BAM_CDEL)
 		{
 			int32_t s = p - bam_cigar_oplen(cigar[k]);
-			itvd.push_back(pack(s, p));
+			*(xd++) = pack(s, p);
 		}
 	}
 
 	//printf("call regular constructor\n");
 }
 
+const int64_t* hit::intervals() const
+{
+	return (ext == NULL) ? buf : ext;
+}
+
+interval_list hit::spos() const
+{
+	return interval_list(intervals(), nspos);
+}
+
+interval_list hit::itvm() const
+{
+	return interval_list(intervals() + nspos, nitvm);
+}
+
+interval_list hit::itvi() const
+{
+	return interval_list(intervals() + nspos + nitvm, nitvi);
+}
+
+interval_list hit::itvd() const
+{
+	return interval_list(intervals() + nspos + nitvm + nitvi, nitvd);
+}
+
 int hit::set_tags(bam1_t *b)
 {
 	ts = '.';
@@ -226,8 +295,8 @@ int hit::set_strand()
 
 bool hit::operator<(const hit &h) const
 {
-	if(qname < h.qname) return true;
-	if(qname > h.qname) return false;
+	if(qhash < h.qhash) return true;
+	if(qhash > h.qhash) return false;
 	if(hi != -1 && h.hi != -1 && hi < h.hi) return true;
 	if(hi != -1 && h.hi != -1 && hi > h.hi) return false;
 	return (pos < h.pos);
@@ -236,13 +305,14 @@ bool hit::operator<(const hit &h) const
 int hit::print() const
 {
 	// print basic information
-	printf("Hit %s: [%d-%d), mpos = %d, flag = %d, quality = %d, strand = %c, xs = %c, ts = %c, isize = %d, qlen = %d, hi = %d\n", 
-			qname.c_str(), pos, rpos, mpos, flag, qual, strand, xs, ts, isize, qlen, hi);
+	printf("Hit %016llx: [%d-%d), mpos = %d, flag = %d, quality = %d, strand = %c, xs = %c, ts = %c, isize = %d, qlen = %d, hi = %d\n", 
+			(unsigned long long)qhash, pos, rpos, mpos, flag, qual, strand, xs, ts, isize, qlen, hi);
 
+	interval_list v = spos();
 	printf(" start position (%d - )\n", pos);
-	for(int i = 0; i < spos.size(); i++)
+	for(int i = 0; i < v.size(); i++)
 	{
-		int64_t p = spos[i];
+		int64_t p = v[i];
 		int32_t p1 = high32(p);
 		int32_t p2 = low32(p);
 		printf(" splice position (%d - %d)\n", p1, p2);
@@ -7,6 +7,7 @@ See LICENSE for licensing.
 #ifndef __HIT_H__
 #define __HIT_H__
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -41,20 +42,41 @@ typedef struct {
 } bam1_core_t;
 */
 
+// number of intervals a hit keeps inline, equal to the default max_num_cigar;
+// hits with more intervals (only if --max_num_cigar is raised) use the heap
+#define HIT_INLINE_INTERVALS 7
+
+// read-only list of intervals of a hit, each packed as pack(start, end)
+class interval_list
+{
+public:
+	interval_list(const int64_t *_x, int _n) : x(_x), n(_n) {}
+
+private:
+	const int64_t *x;
+	int n;
+
+public:
+	int size() const { return n; }
+	int64_t operator[](int k) const { return x[k]; }
+};
+
 class hit: public bam1_core_t
 {
 public:
 	//hit(int32_t p);
 	hit(bam1_t *b);
 	hit(const hit &h);
+	hit(hit &&h);
 	~hit();
 	bool operator<(const hit &h) const;
 	hit& operator=(const hit &h);
+	hit& operator=(hit &&h);
 
 public:
 	int32_t rpos;							// right position mapped to reference [pos, rpos)
 	int32_t qlen;							// read length
-	string qname;							// query name
+	uint64_t qhash;							// hash of query name
 	char strand;							// strandness
 	char xs;								// XS aux in sam
 	char ts;								// ts tag used in minimap2
@@ -62,16 +84,28 @@ public:
 	int32_t hi;								// HI aux in sam
 	int32_t nm;								// NM aux in sam
 	bool concordant;						// whether it is concordant
-	vector<int64_t> spos;					// splice positions
-	vector<int64_t> itvm;					// matched interval
-	vector<int64_t> itvi;					// insert interval
-	vector<int64_t> itvd;					// delete interval
+
+private:
+	uint16_t nspos;							// number of splice positions
+	uint16_t nitvm;							// number of matched intervals
+	uint16_t nitvi;							// number of insert intervals
+	uint16_t nitvd;							// number of delete intervals
+	int64_t buf[HIT_INLINE_INTERVALS];		// spos, itvm, itvi and itvd, in this order
+	int64_t *ext;							// used instead of buf if it is too small
 
 public:
+	interval_list spos() const;				// splice positions
+	interval_list itvm() const;				// matched interval
+	interval_list itvi() const;				// insert interval
+	interval_list itvd() const;				// delete interval
+
 	int set_tags(bam1_t *b);
 	int set_strand();
 	int set_concordance();
 	int print() const;
+
+private:
+	const int64_t *intervals() const;
 };
 
 //inline bool hit_compare_by_name(const hit &x, const hit &y);
@@ -8,6 +8,7 @@ See LICENSE for licensing.
 #include "config.h"
 #include <algorithm>
 #include <cstdio>
+#include <fstream>
 
 int hyper_set::clear()
 {
@@ -39,14 +40,14 @@ int hyper_set::add_node_list(const vector<int> &s, int c)
 	return 0;
 }
 
-int hyper_set::build(directed_graph &gr, MEI& e2i)
+int hyper_set::build(directed_graph &gr, EPI &e2i)
 {
 	build_edges(gr, e2i);
 	build_index();
 	return 0;
 }
 
-int hyper_set::build_edges(directed_graph &gr, MEI& e2i)
+int hyper_set::build_edges(directed_graph &gr, EPI &e2i)
 {
 	edges.clear();
 	for(MVII::iterator it = nodes.begin(); it != nodes.end(); it++)
@@ -108,16 +109,7 @@ int hyper_set::build_index()
 		{
 			int e = v[j];
 			if(e == -1) continue;
-			if(e2s.find(e) == e2s.end())
-			{
-				set<int> s;
-				s.insert(i);
-				e2s.insert(PISI(e, s));
-			}
-			else
-			{
-				e2s[e].insert(i);
-			}
+			index(e).set(i);
 		}
 	}
 	return 0;
@@ -125,61 +117,59 @@ int hyper_set::build_index()
 
 int hyper_set::update_index()
 {
-	vector<int> fb1;
-	for(MISI::iterator p = e2s.begin(); p != e2s.end(); p++)
+	for(int e = 0; e < e2s.size(); e++)
 	{
-		int e = p->first;
-		set<int> &ss = p->second;
-		vector<int> fb2;
-		for(set<int>::iterator it = ss.begin(); it != ss.end(); it++)
+		bitmap &ss = e2s[e];
+		for(int k = ss.next(0); k != -1; k = ss.next(k + 1))
 		{
-			vector<int> &v = edges[*it];
+			vector<int> &v = edges[k];
 			for(int i = 0; i < v.size(); i++)
 			{
 				if(v[i] != e) continue;
 				bool b1 = false, b2 = false;
 				if(i == 0 || v[i - 1] == -1) b1 = true;
 				if(i == v.size() - 1 || v[i + 1] == -1) b2 = true;
-				if(b1 == true && b2 == true) fb2.push_back(*it);
+				if(b1 == true && b2 == true) ss.reset(k);
 				break;
 			}
 		}
-		for(int i = 0; i < fb2.size(); i++) ss.erase(fb2[i]);
-		if(ss.size() == 0) fb1.push_back(e);
 	}
-	for(int i = 0; i < fb1.size(); i++) e2s.erase(fb1[i]);
 	return 0;
 }
 
-set<int> hyper_set::get_intersection(const vector<int> &v)
+bitmap& hyper_set::index(int e)
 {
-	set<int> ss;
-	if(v.size() == 0) return ss;
+	assert(e >= 0);
+	if(e >= e2s.size()) e2s.resize(e + 1);
+	return e2s[e];
+}
+
+int hyper_set::get_intersection(const vector<int> &v, bitmap &s)
+{
+	s.clear();
+	if(v.size() == 0) return 0;
 	assert(v[0] >= 0);
-	if(e2s.find(v[0]) == e2s.end()) return ss;
-	ss = e2s[v[0]];
-	vector<int> vv(ss.size());
+	if(v[0] >= e2s.size()) return 0;
+	s.assign(e2s[v[0]]);
 	for(int i = 1; i < v.size(); i++)
 	{
 		assert(v[i] >= 0);
-		set<int> s;
-		if(e2s.find(v[i]) == e2s.end()) return s;
-		s = e2s[v[i]];
-		vector<int>::iterator it = set_intersection(ss.begin(), ss.end(), s.begin(), s.end(), vv.begin());
-		ss = set<int>(vv.begin(), it);
+		if(v[i] >= e2s.size()) s.clear();
+		else s.intersect(e2s[v[i]]);
+		if(s.empty()) return 0;
 	}
-	return ss;
+	return 0;
 }
 
 MI hyper_set::get_successors(int e)
 {
 	MI s;
-	if(e2s.find(e) == e2s.end()) return s;
-	set<int> &ss = e2s[e];
-	for(set<int>::iterator it = ss.begin(); it != ss.end(); it++)
+	if(e < 0 || e >= e2s.size()) return s;
+	bitmap &ss = e2s[e];
+	for(int k = ss.next(0); k != -1; k = ss.next(k + 1))
 	{
-		vector<int> &v = edges[*it];
-		int c = ecnts[*it];
+		vector<int> &v = edges[k];
+		int c = ecnts[k];
 		for(int i = 0; i < v.size(); i++)
 		{
 			if(v[i] != e) continue;
@@ -196,12 +186,12 @@ MI hyper_set::get_successors(int e)
 MI hyper_set::get_predecessors(int e)
 {
 	MI s;
-	if(e2s.find(e) == e2s.end()) return s;
-	set<int> &ss = e2s[e];
-	for(set<int>::iterator it = ss.begin(); it != ss.end(); it++)
+	if(e < 0 || e >= e2s.size()) return s;
+	bitmap &ss = e2s[e];
+	for(int k = ss.next(0); k != -1; k = ss.next(k + 1))
 	{
-		vector<int> &v = edges[*it];
-		int c = ecnts[*it];
+		vector<int> &v = edges[k];
+		int c = ecnts[k];
 		for(int i = 0; i < v.size(); i++)
 		{
 			if(v[i] != e) continue;
@@ -215,7 +205,7 @@ MI hyper_set::get_predecessors(int e)
 	return s;
 }
 
-MPII hyper_set::get_routes(int x, directed_graph &gr, MEI &e2i)
+MPII hyper_set::get_routes(int x, directed_graph &gr, EPI &e2i)
 {
 	MPII mpi;
 	edge_iterator it1, it2;
@@ -223,7 +213,7 @@ MPII hyper_set::get_routes(int x, directed_graph &gr, MEI &e2i)
 	vector<PI> v;
 	for(pei = gr.in_edges(x), it1 = pei.first, it2 = pei.second; it1 != it2; it1++)
 	{
-		assert(e2i.find(*it1) != e2i.end());
+		assert(e2i.contain(*it1));
 		int e = e2i[*it1];
 		MI s = get_successors(e);
 		for(MI::iterator it = s.begin(); it != s.end(); it++)
@@ -236,14 +226,14 @@ MPII hyper_set::get_routes(int x, directed_graph &gr, MEI &e2i)
 }
 
 /*
-int hyper_set::get_routes(int x, directed_graph &gr, MEI &e2i, MPII &mpi)
+int hyper_set::get_routes(int x, directed_graph &gr, EPI &e2i, MPII &mpi)
 {
 	edge_iterator it1, it2;
 	mpi.clear();
 	int total = 0;
 	for(tie(it1, it2) = gr.in_edges(x); it1 != it2; it1++)
 	{
-		assert(e2i.find(*it1) != e2i.end());
+		assert(e2i.contain(*it1));
 		int e = e2i[*it1];
 
 		if(e2s.find(e) == e2s.end()) continue;
@@ -291,12 +281,12 @@ int hyper_set::replace(int x, int y, int e)
 int hyper_set::replace(const vector<int> &v, int e)
 {
 	if(v.size() == 0) return 0;
-	set<int> s = get_intersection(v);
-	
+	get_intersection(v, cs);
+	bitmap &se = index(e);
+
 	vector<int> fb;
-	for(set<int>::iterator it = s.begin(); it != s.end(); it++)
+	for(int k = cs.next(0); k != -1; k = cs.next(k + 1))
 	{
-		int k = (*it);
 		vector<int> &vv = edges[k];
 		vector<int> bv = consecutive_subset(vv, v);
 
@@ -316,25 +306,14 @@ int hyper_set::replace(const vector<int> &v, int e)
 		}
 
 		vv.erase(vv.begin() + b + 1, vv.begin() + b + v.size());
-
-		if(e2s.find(e) == e2s.end())
-		{
-			set<int> ss;
-			ss.insert(k);
-			e2s.insert(PISI(e, ss));
-		}
-		else
-		{
-			e2s[e].insert(k);
-		}
+		se.set(k);
 	}
 
 	for(int i = 0; i < v.size(); i++)
 	{
 		int u = v[i];
-		if(e2s.find(u) == e2s.end()) continue;
-		for(int k = 0; k < fb.size(); k++) e2s[u].erase(fb[k]);
-		if(e2s[u].size() == 0) e2s.erase(u);
+		if(u >= e2s.size()) continue;
+		for(int k = 0; k < fb.size(); k++) e2s[u].reset(fb[k]);
 	}
 	return 0;
 }
@@ -352,12 +331,10 @@ int hyper_set::remove(const vector<int> &v)
 
 int hyper_set::remove(int e)
 {
-	if(e2s.find(e) == e2s.end()) return 0;
-	set<int> &s = e2s[e];
-	vector<int> fb;
-	for(set<int>::iterator it = s.begin(); it != s.end(); it++)
+	if(e < 0 || e >= e2s.size()) return 0;
+	bitmap &s = e2s[e];
+	for(int k = s.next(0); k != -1; k = s.next(k + 1))
 	{
-		int k = (*it);
 		vector<int> &vv = edges[k];
 		assert(vv.size() >= 1);
 
@@ -366,28 +343,21 @@ int hyper_set::remove(int e)
 			if(vv[i] != e) continue;
 
 			vv[i] = -1;
-
-			bool b1 = useful(vv, 0, i - 1);
-			bool b2 = useful(vv, i + 1, vv.size() - 1);
-			if(b1 == false && b2 == false) fb.push_back(k);
-			 
 			break;
 		}
 	}
 
-	for(int i = 0; i < fb.size(); i++) s.erase(fb[i]);
-	e2s.erase(e);
+	s.clear();
 	return 0;
 }
 
 int hyper_set::remove_pair(int x, int y)
 {
-	if(e2s.find(x) == e2s.end()) return 0;
-	set<int> &s = e2s[x];
+	if(x < 0 || x >= e2s.size()) return 0;
+	bitmap &s = e2s[x];
 	vector<int> fb;
-	for(set<int>::iterator it = s.begin(); it != s.end(); it++)
+	for(int k = s.next(0); k != -1; k = s.next(k + 1))
 	{
-		int k = (*it);
 		vector<int> &vv = edges[k];
 		assert(vv.size() >= 1);
 
@@ -407,8 +377,7 @@ int hyper_set::remove_pair(int x, int y)
 		}
 	}
 
-	for(int i = 0; i < fb.size(); i++) s.erase(fb[i]);
-	if(s.size() == 0) e2s.erase(x);
+	for(int i = 0; i < fb.size(); i++) s.reset(fb[i]);
 
 	return 0;
 }
@@ -424,11 +393,11 @@ bool hyper_set::useful(const vector<int> &v, int k1, int k2)
 
 int hyper_set::insert_between(int x, int y, int e)
 {
-	if(e2s.find(x) == e2s.end()) return 0;
-	set<int> s = e2s[x];
-	for(set<int>::iterator it = s.begin(); it != s.end(); it++)
+	if(x < 0 || x >= e2s.size()) return 0;
+	bitmap &se = index(e);
+	bitmap &s = e2s[x];
+	for(int k = s.next(0); k != -1; k = s.next(k + 1))
 	{
-		int k = (*it);
 		vector<int> &vv = edges[k];
 		assert(vv.size() >= 1);
 
@@ -438,17 +407,7 @@ int hyper_set::insert_between(int x, int y, int e)
 			if(vv[i] != x) continue;
 			if(vv[i + 1] != y) continue;
 			vv.insert(vv.begin() + i + 1, e);
-
-			if(e2s.find(e) == e2s.end())
-			{
-				set<int> ss;
-				ss.insert(k);
-				e2s.insert(PISI(e, ss));
-			}
-			else
-			{
-				e2s[e].insert(k);
-			}
+			se.set(k);
 
 			//printf("line %d: insert %d between (%d, %d) = (%d, %d, %d)\n", k, e, x, y, vv[i], vv[i + 1], vv[i + 2]);
 
@@ -465,11 +424,10 @@ bool hyper_set::extend(int e)
 
 bool hyper_set::left_extend(int e)
 {
-	if(e2s.find(e) == e2s.end()) return false;
-	set<int> s = e2s[e];
-	for(set<int>::iterator it = s.begin(); it != s.end(); it++)
+	if(e < 0 || e >= e2s.size()) return false;
+	bitmap &s = e2s[e];
+	for(int k = s.next(0); k != -1; k = s.next(k + 1))
 	{
-		int k = (*it);
 		vector<int> &vv = edges[k];
 		assert(vv.size() >= 1);
 
@@ -483,11 +441,10 @@ bool hyper_set::left_extend(int e)
 
 bool hyper_set::right_extend(int e)
 {
-	if(e2s.find(e) == e2s.end()) return false;
-	set<int> s = e2s[e];
-	for(set<int>::iterator it = s.begin(); it != s.end(); it++)
+	if(e < 0 || e >= e2s.size()) return false;
+	bitmap &s = e2s[e];
+	for(int k = s.next(0); k != -1; k = s.next(k + 1))
 	{
-		int k = (*it);
 		vector<int> &vv = edges[k];
 		assert(vv.size() >= 1);
 
@@ -521,14 +478,13 @@ bool hyper_set::left_dominate(int e)
 {
 	// for each appearance of e
 	// if right is not empty then left is also not empty
-	if(e2s.find(e) == e2s.end()) return true;
+	if(e < 0 || e >= e2s.size() || e2s[e].empty()) return true;
 
 	set<PI> x1;
 	set<PI> x2;
-	set<int> s = e2s[e];
-	for(set<int>::iterator it = s.begin(); it != s.end(); it++)
+	bitmap &s = e2s[e];
+	for(int k = s.next(0); k != -1; k = s.next(k + 1))
 	{
-		int k = (*it);
 		vector<int> &vv = edges[k];
 		assert(vv.size() >= 1);
 
@@ -562,13 +518,12 @@ bool hyper_set::right_dominate(int e)
 {
 	// for each appearance of e
 	// if left is not empty then right is also not empty
-	if(e2s.find(e) == e2s.end()) return true;
+	if(e < 0 || e >= e2s.size() || e2s[e].empty()) return true;
 	set<PI> x1;
 	set<PI> x2;
-	set<int> s = e2s[e];
-	for(set<int>::iterator it = s.begin(); it != s.end(); it++)
+	bitmap &s = e2s[e];
+	for(int k = s.next(0); k != -1; k = s.next(k + 1))
 	{
-		int k = (*it);
 		vector<int> &vv = edges[k];
 		assert(vv.size() >= 1);
 		for(int i = 1; i < vv.size(); i++)
@@ -620,3 +575,77 @@ int hyper_set::print()
 	*/
 	return 0;
 }
+
+int hyper_set::read(const string &file)
+{
+	// one line per list of nodes: count, size, nodes
+	ifstream fin(file.c_str());
+	if(fin.fail()) return -1;
+
+	clear();
+	int n = 0;
+	fin>>n;
+	for(int i = 0; i < n; i++)
+	{
+		int c, k;
+		fin>>c>>k;
+		vector<int> v(k);
+		for(int j = 0; j < k; j++) fin>>v[j];
+		if(fin.fail()) return -1;
+		nodes[v] += c;			// written as stored, already shifted
+	}
+	return 0;
+}
+
+int hyper_set::write(const string &file) const
+{
+	ofstream fout(file.c_str());
+	if(fout.fail()) return -1;
+
+	fout<<nodes.size()<<endl;
+	for(MVII::const_iterator it = nodes.begin(); it != nodes.end(); it++)
+	{
+		const vector<int> &v = it->first;
+		fout<<it->second<<" "<<v.size();
+		for(int j = 0; j < v.size(); j++) fout<<" "<<v[j];
+		fout<<endl;
+	}
+	fout.close();
+	return 0;
+}
+
+int hyper_set::serialize(binary_writer &w) const
+{
+	w.put((uint32_t)(nodes.size()));
+	for(MVII::const_iterator it = nodes.begin(); it != nodes.end(); it++)
+	{
+		const vector<int> &v = it->first;
+		w.put((int32_t)(it->second));
+		w.put((uint32_t)(v.size()));
+		for(int j = 0; j < v.size(); j++) w.put((int32_t)(v[j]));
+	}
+	return 0;
+}
+
+int hyper_set::deserialize(binary_reader &r)
+{
+	clear();
+	uint32_t n;
+	r.get(n);
+	for(int i = 0; i < n && r.fail() == false; i++)
+	{
+		int32_t c;
+		uint32_t k;
+		r.get(c);
+		r.get(k);
+		vector<int> v;
+		for(int j = 0; j < k && r.fail() == false; j++)
+		{
+			int32_t x;
+			r.get(x);
+			v.push_back(x);
+		}
+		nodes[v] += c;
+	}
+	return r.fail() ? -1 : 0;
+}
@@ -12,14 +12,15 @@ See LICENSE for licensing.
 #include <vector>
 
 #include "util.h"
+#include "arena.h"
+#include "bitmap.h"
+#include "binary_io.h"
 #include "directed_graph.h"
 
 using namespace std;
 
 typedef pair<vector<int>, int> PVII;
-typedef map<vector<int>, int> MVII;
-typedef map< int, set<int> > MISI;
-typedef pair< int, set<int> > PISI;
+typedef map< vector<int>, int, less< vector<int> >, arena_allocator< pair<const vector<int>, int> > > MVII;
 typedef vector< vector<int> > VVI;
 typedef map< pair<int, int>, int> MPII;
 typedef pair< pair<int, int>, int> PPII;
@@ -30,22 +31,27 @@ public:
 	MVII nodes;			// hyper-edges using list-of-nodes
 	VVI edges;			// hyper-edges using list-of-edges
 	vector<int> ecnts;	// counts for edges
-	MISI e2s;			// index: from edge to hyper-edges
+	vector<bitmap> e2s;	// index: from edge to hyper-edges
+	bitmap cs;			// scratch set of hyper-edges
 
 public:
 	int clear();
 	int add_node_list(const set<int> &s);
 	int add_node_list(const set<int> &s, int c);
 	int add_node_list(const vector<int> &s, int c);
-	int build(directed_graph &gr, MEI &e2i);
-	int build_edges(directed_graph &gr, MEI &e2i);
+	int build(directed_graph &gr, EPI &e2i);
+	int build_edges(directed_graph &gr, EPI &e2i);
 	int build_index();
 	int update_index();
-	set<int> get_intersection(const vector<int> &v);
+	int get_intersection(const vector<int> &v, bitmap &s);
 	MI get_successors(int e);
 	MI get_predecessors(int e);
-	MPII get_routes(int x, directed_graph &gr, MEI &e2i);
+	MPII get_routes(int x, directed_graph &gr, EPI &e2i);
 	int print();
+	int read(const string &file);
+	int write(const string &file) const;
+	int serialize(binary_writer &w) const;
+	int deserialize(binary_reader &r);
 
 public:
 	int replace(int x, int e);
@@ -57,6 +63,7 @@ public:
 	int remove_pair(int x, int y);
 	int insert_between(int x, int y, int e);
 	bool useful(const vector<int> &v, int k1, int k2);
+	bitmap& index(int e);
 	bool extend(int e);
 	bool left_extend(int e);
 	bool left_extend(const vector<int> &s);
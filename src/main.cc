@@ -16,6 +16,8 @@ See LICENSE for licensing.
 #include "config.h"
 #include "previewer.h"
 #include "assembler.h"
+#include "profiler.h"
+#include "graph_bench.h"
 
 using namespace std;
 
@@ -43,7 +45,14 @@ int main(int argc, const char **argv)
 		//print_parameters();
 	}
 
-	if(library_type == EMPTY || preview_only == true)
+	if(algo == "bench")
+	{
+		graph_bench gb(input_file);
+		gb.run();
+		return 0;
+	}
+
+	if(resume_file == "" && (library_type == EMPTY || preview_only == true))
 	{
 		previewer pv;
 		pv.preview();
@@ -51,8 +60,12 @@ int main(int argc, const char **argv)
 
 	if(preview_only == true) return 0;
 
+	if(profile_file != "") prof.start();
+
 	assembler asmb;
-	asmb.assemble();
+	if(asmb.assemble() != 0) return 1;
+
+	if(profile_file != "") prof.write(profile_file);
 
 	return 0;
 }
@@ -0,0 +1,256 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "profiler.h"
+#include "config.h"
+
+#include <ctime>
+#include <cstdio>
+#include <fstream>
+#include <algorithm>
+#include <sys/resource.h>
+
+profiler prof;
+
+static const char *stage_names[NUM_STAGES] = {"decode", "parse", "bundle", "super_graph", "scallop", "router", "filter", "output"};
+static const bool stage_cpu[NUM_STAGES] = {false, false, true, true, true, true, true, true};
+
+static bool slower(const bundle_profile &x, const bundle_profile &y)
+{
+	return x.wall > y.wall;
+}
+
+static string quote(const string &s)
+{
+	string r = "\"";
+	for(int i = 0; i < s.size(); i++)
+	{
+		if(s[i] == '"' || s[i] == '\\') r += '\\';
+		if((unsigned char)(s[i]) < 0x20) continue;
+		r += s[i];
+	}
+	return r + "\"";
+}
+
+int64_t wall_clock()
+{
+	timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+int64_t cpu_clock()
+{
+	timespec t;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+	return t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+const char *stage_name(int s)
+{
+	return stage_names[s];
+}
+
+profiler::profiler()
+{
+	clear();
+}
+
+int profiler::clear()
+{
+	enabled = false;
+	start_time = 0;
+	for(int i = 0; i < NUM_STAGES; i++)
+	{
+		calls[i] = 0;
+		wall[i] = 0;
+		cpu[i] = 0;
+	}
+	num_bundles = 0;
+	num_hits = 0;
+	max_hits = 0;
+	num_allocations = 0;
+	max_memory = 0;
+	hist.assign(PROFILE_NUM_BINS, 0);
+	worst.clear();
+	fallbacks.clear();
+	return 0;
+}
+
+int profiler::start()
+{
+	enabled = true;
+	start_time = wall_clock();
+	return 0;
+}
+
+double profiler::elapsed() const
+{
+	return (wall_clock() - start_time) * 1e-9;
+}
+
+double profiler::wall_seconds(int s) const
+{
+	return wall[s] * 1e-9;
+}
+
+double profiler::cpu_seconds(int s) const
+{
+	if(stage_cpu[s] == false) return -1;
+	return cpu[s] * 1e-9;
+}
+
+int profiler::add(int s, int64_t w, int64_t c, int64_t n)
+{
+	calls[s] += n;
+	wall[s] += w;
+	cpu[s] += c;
+	return 0;
+}
+
+int profiler::add(const bundle_profile &b)
+{
+	int k = 0;
+	while(k + 1 < PROFILE_NUM_BINS && (2LL << k) <= b.num_hits) k++;
+
+	lock.lock();
+	num_bundles++;
+	num_hits += b.num_hits;
+	if(b.num_hits > max_hits) max_hits = b.num_hits;
+	num_allocations += b.num_allocations;
+	if(b.memory > max_memory) max_memory = b.memory;
+	hist[k]++;
+	if(b.num_fallbacks >= 1) fallbacks.push_back(b);
+
+	if(worst.size() < PROFILE_NUM_BUNDLES)
+	{
+		worst.push_back(b);
+		push_heap(worst.begin(), worst.end(), slower);
+	}
+	else if(b.wall > worst[0].wall)
+	{
+		pop_heap(worst.begin(), worst.end(), slower);
+		worst.back() = b;
+		push_heap(worst.begin(), worst.end(), slower);
+	}
+	lock.unlock();
+	return 0;
+}
+
+static int write_bundle(ofstream &fout, const bundle_profile &b)
+{
+	fout<<"    {\"chrm\": "<<quote(b.chrm)<<", ";
+	fout<<"\"lpos\": "<<b.lpos<<", ";
+	fout<<"\"rpos\": "<<b.rpos<<", ";
+	fout<<"\"strand\": \""<<b.strand<<"\", ";
+	fout<<"\"hits\": "<<b.num_hits<<", ";
+	fout<<"\"vertices\": "<<b.num_vertices<<", ";
+	fout<<"\"edges\": "<<b.num_edges<<", ";
+	fout<<"\"transcripts\": "<<b.num_transcripts<<", ";
+	fout<<"\"estimated_cost\": "<<b.cost<<", ";
+	fout<<"\"fallbacks\": "<<b.num_fallbacks<<", ";
+	fout<<"\"wall_seconds\": "<<b.wall * 1e-9<<", ";
+	fout<<"\"cpu_seconds\": "<<b.cpu * 1e-9<<", ";
+	fout<<"\"arena_allocations\": "<<b.num_allocations<<", ";
+	fout<<"\"arena_bytes\": "<<b.memory<<"}";
+	return 0;
+}
+
+int profiler::write(const string &file)
+{
+	if(enabled == false) return 0;
+
+	ofstream fout(file.c_str());
+	if(fout.fail())
+	{
+		printf("error: cannot write profile to %s\n", file.c_str());
+		return -1;
+	}
+
+	rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	double ucpu = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec * 1e-6;
+	double scpu = ru.ru_stime.tv_sec + ru.ru_stime.tv_usec * 1e-6;
+
+	fout.precision(6);
+	fout<<fixed;
+
+	fout<<"{\n";
+	fout<<"  \"version\": "<<quote(version)<<",\n";
+	fout<<"  \"input\": "<<quote(input_file)<<",\n";
+	fout<<"  \"threads\": "<<num_threads<<",\n";
+	fout<<"  \"wall_seconds\": "<<elapsed()<<",\n";
+	fout<<"  \"user_seconds\": "<<ucpu<<",\n";
+	fout<<"  \"system_seconds\": "<<scpu<<",\n";
+	fout<<"  \"peak_rss_kb\": "<<ru.ru_maxrss<<",\n";
+
+	fout<<"  \"stages\": {\n";
+	for(int i = 0; i < NUM_STAGES; i++)
+	{
+		fout<<"    "<<quote(stage_names[i])<<": {";
+		fout<<"\"calls\": "<<calls[i]<<", ";
+		fout<<"\"wall_seconds\": "<<wall[i] * 1e-9<<", ";
+		if(stage_cpu[i] == true) fout<<"\"cpu_seconds\": "<<cpu[i] * 1e-9<<"}";
+		else fout<<"\"cpu_seconds\": null}";
+		fout<<(i + 1 < NUM_STAGES ? ",\n" : "\n");
+	}
+	fout<<"  },\n";
+
+	fout<<"  \"bundles\": {\n";
+	fout<<"    \"count\": "<<num_bundles<<",\n";
+	fout<<"    \"hits\": "<<num_hits<<",\n";
+	fout<<"    \"max_hits\": "<<max_hits<<",\n";
+	fout<<"    \"arena_allocations\": "<<num_allocations<<",\n";
+	fout<<"    \"max_arena_bytes\": "<<max_memory<<",\n";
+	fout<<"    \"fallbacks\": "<<fallbacks.size()<<",\n";
+	fout<<"    \"hits_histogram\": [";
+	int m = PROFILE_NUM_BINS;
+	while(m >= 1 && hist[m - 1] == 0) m--;
+	for(int k = 0; k < m; k++)
+	{
+		fout<<(k == 0 ? "" : ", ")<<"{\"min_hits\": "<<(1LL << k)<<", \"count\": "<<hist[k]<<"}";
+	}
+	fout<<"]\n";
+	fout<<"  },\n";
+
+	vector<bundle_profile> v = worst;
+	sort(v.begin(), v.end(), slower);
+
+	fout<<"  \"worst_bundles\": [\n";
+	for(int i = 0; i < v.size(); i++)
+	{
+		write_bundle(fout, v[i]);
+		fout<<(i + 1 < v.size() ? ",\n" : "\n");
+	}
+	fout<<"  ],\n";
+
+	fout<<"  \"fallback_bundles\": [\n";
+	for(int i = 0; i < fallbacks.size(); i++)
+	{
+		write_bundle(fout, fallbacks[i]);
+		fout<<(i + 1 < fallbacks.size() ? ",\n" : "\n");
+	}
+	fout<<"  ]\n";
+	fout<<"}\n";
+
+	fout.close();
+	return 0;
+}
+
+stage_timer::stage_timer(int s)
+{
+	stage = -1;
+	if(prof.active() == false) return;
+	stage = s;
+	w = wall_clock();
+	c = cpu_clock();
+}
+
+stage_timer::~stage_timer()
+{
+	if(stage < 0) return;
+	prof.add(stage, wall_clock() - w, cpu_clock() - c);
+}
@@ -0,0 +1,102 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+using namespace std;
+
+#define PROFILE_NUM_BUNDLES 20			// number of slowest bundles reported
+#define PROFILE_NUM_BINS 32				// bins of the histogram of bundle sizes
+
+// stages of the pipeline; they may be nested, e.g., router is
+// part of scallop, so their times are inclusive; decode and parse
+// are timed for each read, on the wall clock only
+enum {STAGE_DECODE, STAGE_PARSE, STAGE_BUNDLE, STAGE_SUPER_GRAPH, STAGE_SCALLOP, STAGE_ROUTER, STAGE_FILTER, STAGE_OUTPUT, NUM_STAGES};
+
+class bundle_profile
+{
+public:
+	string chrm;					// chromosome name
+	int32_t lpos;					// leftmost boundary on reference
+	int32_t rpos;					// rightmost boundary on reference
+	char strand;					// strandness
+	int num_hits;					// number of hits
+	int num_vertices;				// size of splice graph
+	int num_edges;					// size of splice graph
+	int num_transcripts;			// number of assembled transcripts
+	double cost;					// estimated cost of decomposition
+	int num_fallbacks;				// subgraphs decomposed greedily over budget
+	int64_t wall;					// wall time, in nanoseconds
+	int64_t cpu;					// cpu time, in nanoseconds
+	size_t num_allocations;			// blocks allocated from the arena
+	size_t memory;					// size of the arena, in bytes
+};
+
+// run-wide statistics; disabled unless started, in which case
+// each stage costs two clock reads per call
+class profiler
+{
+public:
+	profiler();
+
+private:
+	bool enabled;									// whether started
+	int64_t start_time;								// wall clock at start
+	atomic<int64_t> calls[NUM_STAGES];				// number of calls of each stage
+	atomic<int64_t> wall[NUM_STAGES];				// wall time of each stage
+	atomic<int64_t> cpu[NUM_STAGES];				// cpu time of each stage
+
+	mutex lock;										// protect the fields below
+	vector<bundle_profile> worst;					// slowest bundles, a min-heap on wall time
+	int64_t num_bundles;							// number of assembled bundles
+	int64_t num_hits;								// total hits of these bundles
+	int64_t max_hits;								// hits of the largest bundle
+	int64_t num_allocations;						// total blocks allocated from arenas
+	int64_t max_memory;								// size of the largest arena
+	vector<int64_t> hist;							// bundles, by floor(log2(hits))
+	vector<bundle_profile> fallbacks;				// bundles over budget, in order of completion
+
+public:
+	int start();
+	int clear();
+	bool active() const { return enabled; }
+	int add(int s, int64_t w, int64_t c, int64_t n = 1);
+	int add(const bundle_profile &b);
+	int write(const string &file);
+
+	double elapsed() const;							// seconds since start
+	double wall_seconds(int s) const;
+	double cpu_seconds(int s) const;				// negative if not measured
+};
+
+extern profiler prof;
+
+const char *stage_name(int s);
+
+int64_t wall_clock();				// monotonic, in nanoseconds
+int64_t cpu_clock();				// cpu time of this thread, in nanoseconds
+
+// charge the lifetime of a scope to a stage
+class stage_timer
+{
+public:
+	stage_timer(int s);
+	~stage_timer();
+
+private:
+	int stage;						// -1 if profiling is disabled
+	int64_t w;						// wall clock at construction
+	int64_t c;						// cpu clock at construction
+};
+
+#endif
@@ -11,7 +11,7 @@ See LICENSE for licensing.
 
 using namespace std;
 
-region::region(int32_t _lpos, int32_t _rpos, int _ltype, int _rtype, const split_interval_map *_mmap, const split_interval_map *_imap)
+region::region(int32_t _lpos, int32_t _rpos, int _ltype, int _rtype, const coverage_map *_mmap, const coverage_map *_imap)
 	:lpos(_lpos), rpos(_rpos), mmap(_mmap), imap(_imap), ltype(_ltype), rtype(_rtype)
 {
 
@@ -28,12 +28,12 @@ int region::build_join_interval_map()
 {
 	jmap.clear();
 
-	PSIMI pei = locate_boundary_iterators(*mmap, lpos, rpos);
-	SIMI lit = pei.first, rit = pei.second;
+	PCMI pei = locate_boundary_iterators(*mmap, lpos, rpos);
+	CMI lit = pei.first, rit = pei.second;
 
 	if(lit == mmap->end() || rit == mmap->end()) return 0;
 
-	SIMI it = lit;
+	CMI it = lit;
 	while(true)
 	{
 		//if(it->second >= 2) 
@@ -55,8 +55,8 @@ int region::split_join_interval_map()
 	if(lower(jmap.begin()->first) != lpos) return 0;
 	if(upper(jmap.begin()->first) == rpos) return 0;
 
-	PSIMI pei = locate_boundary_iterators(*mmap, lpos, rpos);
-	SIMI lit = pei.first, rit = pei.second;
+	PCMI pei = locate_boundary_iterators(*mmap, lpos, rpos);
+	CMI lit = pei.first, rit = pei.second;
 	if(lit == mmap->end() || rit == mmap->end()) return 0;
 
 	int32_t min_split_middle_length = 10;
@@ -67,7 +67,7 @@ int region::split_join_interval_map()
 	if(rpos - lpos < 100) return 0;
 
 	int32_t p = lpos;
-	for(SIMI it = lit; it != rit; it++)
+	for(CMI it = lit; it != rit; it++)
 	{
 		int32_t p1 = lower(it->first);
 		int32_t p2 = upper(it->first);
@@ -141,8 +141,8 @@ bool region::empty_subregion(int32_t p1, int32_t p2)
 	//printf(" region = [%d, %d), subregion [%d, %d), length = %d\n", lpos, rpos, p1, p2, p2 - p1);
 	if(p2 - p1 < min_subregion_length) return true;
 
-	PSIMI pei = locate_boundary_iterators(*mmap, p1, p2);
-	SIMI it1 = pei.first, it2 = pei.second;
+	PCMI pei = locate_boundary_iterators(*mmap, p1, p2);
+	CMI it1 = pei.first, it2 = pei.second;
 	if(it1 == mmap->end() || it2 == mmap->end()) return true;
 
 	int32_t sum = compute_sum_overlap(*mmap, it1, it2);
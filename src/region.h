@@ -10,6 +10,7 @@ See LICENSE for licensing.
 #include <stdint.h>
 #include <vector>
 #include "interval_map.h"
+#include "coverage_map.h"
 #include "partial_exon.h"
 
 using namespace std;
@@ -19,7 +20,7 @@ typedef pair<int, int> PI;
 class region
 {
 public:
-	region(int32_t _lpos, int32_t _rpos, int _ltype, int _rtype, const split_interval_map *_mmap, const split_interval_map *_imap);
+	region(int32_t _lpos, int32_t _rpos, int _ltype, int _rtype, const coverage_map *_mmap, const coverage_map *_imap);
 	~region();
 
 public:
@@ -27,8 +28,8 @@ public:
 	int32_t rpos;					// the rightmost boundary on reference
 	int ltype;						// type of the left boundary
 	int rtype;						// type of the right boundary
-	const split_interval_map *mmap;	// pointer to match interval map
-	const split_interval_map *imap;	// pointer to indel interval map
+	const coverage_map *mmap;		// pointer to match interval map
+	const coverage_map *imap;		// pointer to indel interval map
 	join_interval_map jmap;			// subregion intervals
 
 	vector<partial_exon> pexons;	// generated partial exons
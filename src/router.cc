@@ -8,6 +8,7 @@ See LICENSE for licensing.
 #include "config.h"
 #include "util.h"
 #include "subsetsum.h"
+#include "profiler.h"
 
 #include <iomanip>
 #include <cassert>
@@ -23,12 +24,12 @@ See LICENSE for licensing.
 #include "CoinBuild.hpp"
 #endif
 
-router::router(int r, splice_graph &g, MEI &ei, VE &ie)
+router::router(int r, splice_graph &g, EPI &ei, VE &ie)
 	:root(r), gr(g), e2i(ei), i2e(ie), degree(-1), type(-1)
 {
 }
 
-router::router(int r, splice_graph &g, MEI &ei, VE &ie, const MPII &mpi)
+router::router(int r, splice_graph &g, EPI &ei, VE &ie, const MPII &mpi)
 	:root(r), gr(g), e2i(ei), i2e(ie), degree(-1), type(-1)
 {
 	routes.clear();
@@ -118,6 +119,7 @@ int router::classify()
 
 int router::build()
 {
+	stage_timer st(STAGE_ROUTER);
 	if(type == SPLITTABLE_SIMPLE || type == SPLITTABLE_HYPER) 
 	{
 		split();
@@ -24,14 +24,14 @@ using namespace std;
 class router
 {
 public:
-	router(int r, splice_graph &g, MEI &ei, VE &ie);
-	router(int r, splice_graph &g, MEI &ei, VE &ie, const MPII &mpi);
+	router(int r, splice_graph &g, EPI &ei, VE &ie);
+	router(int r, splice_graph &g, EPI &ei, VE &ie, const MPII &mpi);
 	router& operator=(const router &rt);
 
 public:
 	int root;					// central vertex
 	splice_graph &gr;			// reference splice graph
-	MEI &e2i;					// reference map of edge to index
+	EPI &e2i;					// reference map of edge to index
 	VE &i2e;					// reference map of index to edge
 	vector<PI> routes;			// pairs of connections
 	vector<int> counts;			// counts for routes
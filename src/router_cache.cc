@@ -0,0 +1,197 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "router_cache.h"
+#include "config.h"
+
+#include <cassert>
+
+router_signature::router_signature()
+{
+	in_degree = 0;
+}
+
+bool router_signature::operator==(const router_signature &s) const
+{
+	if(in_degree != s.in_degree) return false;
+	if(edges != s.edges) return false;
+	if(weights != s.weights) return false;
+	if(routes != s.routes) return false;
+	return true;
+}
+
+bool router_signature::operator!=(const router_signature &s) const
+{
+	return !(*this == s);
+}
+
+int router_signature::clear()
+{
+	edges.clear();
+	weights.clear();
+	in_degree = 0;
+	routes.clear();
+	return 0;
+}
+
+router_cache::router_cache()
+{
+	qa.resize(TRIVIAL_VERTEX + 1);
+	q1.resize(TRIVIAL_VERTEX + 1);
+	ub.resize(TRIVIAL_VERTEX + 1);
+}
+
+int router_cache::resize(int n)
+{
+	int m = type.size();
+	if(n <= m) return 0;
+	type.resize(n, -1);
+	degree.resize(n, -1);
+	built.resize(n, false);
+	ratio.resize(n, 0);
+	eqns.resize(n);
+	pe2w.resize(n);
+	sigs.resize(n);
+	dirty.resize(n, false);
+	for(int v = m; v < n; v++) invalidate(v);
+	return 0;
+}
+
+int router_cache::invalidate(int v)
+{
+	if(v >= dirty.size()) resize(v + 1);
+	if(dirty[v] == true) return 0;
+	dirty[v] = true;
+	pending.push_back(v);
+	return 0;
+}
+
+int router_cache::clear(int v)
+{
+	assert(v >= 0 && v < type.size());
+	detach(v);
+	type[v] = -1;
+	degree[v] = -1;
+	built[v] = false;
+	ratio[v] = 0;
+	eqns[v].clear();
+	pe2w[v].clear();
+	sigs[v].clear();
+	dirty[v] = false;
+	return 0;
+}
+
+bool router_cache::validate(int v, const router_signature &s)
+{
+	assert(v >= 0 && v < type.size());
+	if(type[v] < 0) return false;
+	if(sigs[v] != s) return false;
+	dirty[v] = false;
+	return true;
+}
+
+int router_cache::classify(int v, const router &rt, const router_signature &s)
+{
+	assert(v >= 0 && v < type.size());
+	assert(rt.root == v);
+	assert(rt.type >= 0 && rt.type < qa.size());
+	detach(v);
+	type[v] = rt.type;
+	degree[v] = rt.degree;
+	built[v] = false;
+	ratio[v] = 0;
+	eqns[v].clear();
+	pe2w[v].clear();
+	sigs[v] = s;
+	dirty[v] = false;
+	ub[rt.type].insert(v);
+	return 0;
+}
+
+int router_cache::assign(int v, const router &rt)
+{
+	assert(v >= 0 && v < type.size());
+	assert(type[v] == rt.type && degree[v] == rt.degree);
+	assert(built[v] == false);
+	int t = rt.type;
+	ub[t].erase(v);
+	built[v] = true;
+	ratio[v] = rt.ratio;
+	eqns[v] = rt.eqns;
+	pe2w[v] = rt.pe2w;
+	qa[t].insert(PDI(rt.ratio, 0 - v));
+	if(rt.degree <= 1) q1[t].insert(PDI(rt.ratio, 0 - v));
+	return 0;
+}
+
+vector<int> router_cache::get_unbuilt(int t, int d) const
+{
+	assert(t >= 0 && t < ub.size());
+	vector<int> v;
+	for(set<int>::const_iterator it = ub[t].begin(); it != ub[t].end(); it++)
+	{
+		if(degree[*it] > d) continue;
+		v.push_back(*it);
+	}
+	return v;
+}
+
+int router_cache::detach(int v)
+{
+	int t = type[v];
+	if(t < 0) return 0;
+	if(built[v] == false)
+	{
+		ub[t].erase(v);
+		return 0;
+	}
+	qa[t].erase(PDI(ratio[v], 0 - v));
+	if(degree[v] <= 1) q1[t].erase(PDI(ratio[v], 0 - v));
+	return 0;
+}
+
+int router_cache::top(int t, int d, double max_ratio) const
+{
+	// smallest ratio first, and the largest vertex among ties
+	assert(t >= 0 && t < qa.size());
+	const set<PDI> &q = (d <= 1) ? q1[t] : qa[t];
+	for(set<PDI>::const_iterator it = q.begin(); it != q.end(); it++)
+	{
+		if(it->first > max_ratio) break;
+		int v = 0 - it->second;
+		if(degree[v] > d) continue;
+		return v;
+	}
+	return -1;
+}
+
+int router_cache::next(int t, int d, double max_ratio, int x, int y) const
+{
+	// smallest vertex in (x, y) with ratio below max_ratio
+	assert(t >= 0 && t < qa.size());
+	const set<PDI> &q = (d <= 1) ? q1[t] : qa[t];
+	int k = -1;
+	for(set<PDI>::const_iterator it = q.begin(); it != q.end(); it++)
+	{
+		if(it->first >= max_ratio) break;
+		int v = 0 - it->second;
+		if(degree[v] > d) continue;
+		if(v <= x || v >= y) continue;
+		if(k == -1 || v < k) k = v;
+	}
+	return k;
+}
+
+const vector<int>& router_cache::get_pending() const
+{
+	return pending;
+}
+
+int router_cache::clear_pending()
+{
+	pending.clear();
+	return 0;
+}
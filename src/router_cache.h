@@ -0,0 +1,83 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __ROUTER_CACHE_H__
+#define __ROUTER_CACHE_H__
+
+#include <vector>
+#include <set>
+
+#include "router.h"
+#include "equation.h"
+
+using namespace std;
+
+typedef pair<double, int> PDI;
+
+// everything the router of a vertex reads: its adjacent edges in order,
+// their weights, and the routes through it; routers of two equal
+// signatures are identical
+class router_signature
+{
+public:
+	router_signature();
+
+public:
+	vector<int> edges;					// indices of in-edges, then out-edges
+	vector<double> weights;				// weights of these edges
+	int in_degree;						// number of in-edges
+	MPII routes;						// routes with counts
+
+public:
+	bool operator==(const router_signature &s) const;
+	bool operator!=(const router_signature &s) const;
+	int clear();
+};
+
+// results of routers of all vertices, kept in order of ratio;
+// a vertex is checked only when it is invalidated, i.e., when one
+// of its adjacent edges changes, and is recomputed only if its
+// signature differs; a classified vertex is built only when its
+// type and degree are asked for
+class router_cache
+{
+public:
+	router_cache();
+
+public:
+	vector<int> type;					// router type, -1 if not applicable
+	vector<int> degree;					// router degree
+	vector<bool> built;					// whether ratio and results are computed
+	vector<double> ratio;				// router ratio
+	vector< vector<equation> > eqns;	// split results
+	vector<MPID> pe2w;					// decompose results
+	vector<router_signature> sigs;		// inputs of the cached results
+
+private:
+	vector<bool> dirty;					// whether a vertex is invalidated
+	vector<int> pending;				// invalidated vertices
+	vector< set<int> > ub;				// classified but not built vertices of each type
+	vector< set<PDI> > qa;				// vertices of each type, by (ratio, -vertex)
+	vector< set<PDI> > q1;				// vertices of each type with degree <= 1
+
+public:
+	int resize(int n);
+	int invalidate(int v);
+	int clear(int v);
+	bool validate(int v, const router_signature &s);
+	int classify(int v, const router &rt, const router_signature &s);
+	int assign(int v, const router &rt);
+	vector<int> get_unbuilt(int t, int d) const;
+	int top(int t, int d, double max_ratio) const;
+	int next(int t, int d, double max_ratio, int x, int y) const;
+	const vector<int>& get_pending() const;
+	int clear_pending();
+
+private:
+	int detach(int v);
+};
+
+#endif
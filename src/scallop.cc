@@ -5,7 +5,10 @@ See LICENSE for licensing.
 */
 
 #include "scallop.h"
+#include "bottleneck_path.h"
 #include "config.h"
+#include "arena.h"
+#include "profiler.h"
 
 #include <cstdio>
 #include <iostream>
@@ -14,12 +17,30 @@ See LICENSE for licensing.
 #include <algorithm>
 
 scallop::scallop()
-{}
+{
+	deadline = 0;
+	max_memory = 0;
+	fallback = false;
+}
 
 scallop::scallop(const splice_graph &g, const hyper_set &h)
 	: gr(g), hs(h)
+{
+	init();
+}
+
+scallop::scallop(splice_graph &&g, hyper_set &&h)
+	: gr(std::move(g)), hs(std::move(h))
+{
+	init();
+}
+
+int scallop::init()
 {
 	round = 0;
+	deadline = 0;
+	max_memory = 0;
+	fallback = false;
 	if(output_tex_files == true) gr.draw(gr.gid + "." + tostring(round++) + ".tex");
 
 	gr.get_edge_indices(i2e, e2i);
@@ -29,6 +50,7 @@ scallop::scallop(const splice_graph &g, const hyper_set &h)
 	init_vertex_map();
 	init_inner_weights();
 	init_nonzeroset();
+	return 0;
 }
 
 scallop::~scallop()
@@ -42,10 +64,19 @@ int scallop::assemble()
 
 	//resolve_negligible_edges(false, max_decompose_error_ratio[NEGLIGIBLE_EDGE]);
 
+	gr.tracking = true;
 	while(true)
 	{	
 		if(gr.num_vertices() > max_num_exons) break;
 
+		// the remaining vertices are left to greedy decomposition
+		if(over_budget() == true)
+		{
+			if(verbose >= 1) printf("splice graph %s exceeds its budget, decompose it greedily\n", gr.gid.c_str());
+			fallback = true;
+			break;
+		}
+
 		bool b = false;
 
 		b = resolve_trivial_vertex_fast(max_decompose_error_ratio[TRIVIAL_VERTEX]);
@@ -94,6 +125,8 @@ int scallop::assemble()
 
 		break;
 	}
+	gr.tracking = false;
+	gr.changes.clear();
 
 	collect_existing_st_paths();
 	greedy_decompose();
@@ -110,6 +143,15 @@ int scallop::assemble()
 	return 0;
 }
 
+bool scallop::over_budget() const
+{
+	if(deadline > 0 && wall_clock() > deadline) return true;
+
+	arena *a = arena::current();
+	if(max_memory > 0 && a != NULL && a->capacity() > max_memory) return true;
+	return false;
+}
+
 bool scallop::resolve_smallest_edges(double max_ratio)
 {
 	int se = -1;
@@ -234,43 +276,15 @@ bool scallop::resolve_negligible_edges(bool extend, double max_ratio)
 
 bool scallop::resolve_splittable_vertex(int type, int degree, double max_ratio)
 {
-	int root = -1;
-	double ratio = max_ratio;
-	vector<equation> eqns;
-	//for(set<int>::iterator it = nonzeroset.begin(); it != nonzeroset.end(); it++)
-	//for(int i = 1; i < gr.num_vertices() - 1; i++)
-	vector<int> vv(nonzeroset.begin(), nonzeroset.end());
-	for(int k = 0; k < vv.size(); k++)
-	{
-		int i = vv[k];
-		assert(gr.degree(i) >= 1);
-		if(gr.in_degree(i) <= 1) continue;
-		if(gr.out_degree(i) <= 1) continue;
-
-		assert(gr.in_degree(i) >= 1);
-		assert(gr.out_degree(i) >= 1);
-
-		MPII mpi = hs.get_routes(i, gr, e2i);
-		router rt(i, gr, e2i, i2e, mpi);
-		rt.classify();
-
-		if(rt.type != type) continue;
-		if(rt.degree > degree) continue;
-
-		rt.build();
-		assert(rt.eqns.size() == 2);
-
-		//if(rt.degree == degree && ratio < rt.ratio) continue;
-		if(ratio < rt.ratio) continue;
-
-		root = i;
-		ratio = rt.ratio;
-		eqns = rt.eqns;
-		//degree = rt.degree;
-	}
+	build_routers(type, degree);
 
+	int root = rc.top(type, degree, max_ratio);
 	if(root == -1) return false;
 
+	double ratio = rc.ratio[root];
+	vector<equation> eqns = rc.eqns[root];
+	assert(eqns.size() == 2);
+
 	if(verbose >= 2) printf("resolve splittable vertex, type = %d, degree = %d, vertex = %d, ratio = %.2lf, degree = (%d, %d)\n", 
 			type, degree, root, ratio, gr.in_degree(root), gr.out_degree(root));
 
@@ -281,57 +295,104 @@ bool scallop::resolve_splittable_vertex(int type, int degree, double max_ratio)
 
 bool scallop::resolve_unsplittable_vertex(int type, int degree, double max_ratio)
 {
-	int root = -1;
-	MPID pe2w;
-	double ratio = max_ratio;
+	build_routers(type, degree);
+
+	// vertices that are nearly perfectly decomposed are resolved at once,
+	// in increasing order; those after the current one see the changes
+	// made so far, and vertices created here are not visited
 	bool flag = false;
-	//for(int i = 1; i < gr.num_vertices() - 1; i++)
-	//for(set<int>::iterator it = nonzeroset.begin(); it != nonzeroset.end(); it++)
-	vector<int> vv(nonzeroset.begin(), nonzeroset.end());
-	for(int k = 0; k < vv.size(); k++)
+	int n = gr.num_vertices() - 1;
+	int i = rc.next(type, degree, 0.01, 0, n);
+	while(i != -1)
 	{
-		int i = vv[k];
-		assert(gr.degree(i) >= 1);
-		if(gr.in_degree(i) <= 1) continue;
-		if(gr.out_degree(i) <= 1) continue;
+		if(verbose >= 2) printf("resolve unsplittable vertex, type = %d, degree = %d, vertex = %d, ratio = %.3lf, degree = (%d, %d)\n",
+				type, degree, i, rc.ratio[i], gr.in_degree(i), gr.out_degree(i));
+		MPID pe2w = rc.pe2w[i];
+		decompose_vertex_extend(i, pe2w);
+		flag = true;
 
-		assert(gr.in_degree(i) >= 1);
-		assert(gr.out_degree(i) >= 1);
+		build_routers(type, degree);
+		i = rc.next(type, degree, 0.01, i, n);
+	}
 
-		MPII mpi = hs.get_routes(i, gr, e2i);
-		router rt(i, gr, e2i, i2e, mpi);
-		rt.classify();
+	if(flag == true) return true;
 
-		if(rt.type != type) continue;
-		if(rt.degree > degree) continue;
+	int root = rc.top(type, degree, max_ratio);
+	if(root == -1) return false;
 
-		rt.build();
-		//rt.print();
+	double ratio = rc.ratio[root];
+	MPID pe2w = rc.pe2w[root];
+
+	if(verbose >= 2) printf("resolve unsplittable vertex, type = %d, degree = %d, vertex = %d, ratio = %.3lf, degree = (%d, %d)\n",
+			type, degree, root, ratio, gr.in_degree(root), gr.out_degree(root));
+
+	decompose_vertex_extend(root, pe2w);
+	return true;
+}
+
+int scallop::refresh_routers()
+{
+	rc.resize(gr.num_vertices());
+	for(int k = 0; k < gr.changes.size(); k++) rc.invalidate(gr.changes[k]);
+	gr.changes.clear();
 
-		if(rt.ratio < 0.01)
+	vector<int> v = rc.get_pending();
+	rc.clear_pending();
+	for(int k = 0; k < v.size(); k++)
+	{
+		int i = v[k];
+		if(nonzeroset.find(i) == nonzeroset.end() || gr.in_degree(i) <= 1 || gr.out_degree(i) <= 1)
 		{
-			if(verbose >= 2) printf("resolve unsplittable vertex, type = %d, degree = %d, vertex = %d, ratio = %.3lf, degree = (%d, %d)\n",
-					type, degree, i, rt.ratio, gr.in_degree(i), gr.out_degree(i));
-			decompose_vertex_extend(i, rt.pe2w);
-			flag = true;
+			rc.clear(i);
 			continue;
 		}
 
-		if(rt.ratio > ratio) continue;
+		MPII mpi = hs.get_routes(i, gr, e2i);
+		router_signature sg;
+		build_router_signature(i, mpi, sg);
+		if(rc.validate(i, sg) == true) continue;
 
-		root = i;
-		ratio = rt.ratio;
-		pe2w = rt.pe2w;
+		router rt(i, gr, e2i, i2e, mpi);
+		rt.classify();
+		rc.classify(i, rt, sg);
 	}
+	return 0;
+}
 
-	if(flag == true) return true;
-	if(root == -1) return false;
-
-	if(verbose >= 2) printf("resolve unsplittable vertex, type = %d, degree = %d, vertex = %d, ratio = %.3lf, degree = (%d, %d)\n",
-			type, degree, root, ratio, gr.in_degree(root), gr.out_degree(root));
+int scallop::build_router_signature(int x, const MPII &mpi, router_signature &s)
+{
+	s.clear();
+	edge_iterator it1, it2;
+	PEEI pei;
+	for(pei = gr.in_edges(x), it1 = pei.first, it2 = pei.second; it1 != it2; it1++)
+	{
+		s.edges.push_back(e2i[*it1]);
+		s.weights.push_back(gr.get_edge_weight(*it1));
+	}
+	s.in_degree = s.edges.size();
+	for(pei = gr.out_edges(x), it1 = pei.first, it2 = pei.second; it1 != it2; it1++)
+	{
+		s.edges.push_back(e2i[*it1]);
+		s.weights.push_back(gr.get_edge_weight(*it1));
+	}
+	s.routes = mpi;
+	return 0;
+}
 
-	decompose_vertex_extend(root, pe2w);
-	return true;
+int scallop::build_routers(int type, int degree)
+{
+	refresh_routers();
+	vector<int> v = rc.get_unbuilt(type, degree);
+	for(int k = 0; k < v.size(); k++)
+	{
+		int i = v[k];
+		MPII mpi = hs.get_routes(i, gr, e2i);
+		router rt(i, gr, e2i, i2e, mpi);
+		rt.classify();
+		rt.build();
+		rc.assign(i, rt);
+	}
+	return 0;
 }
 
 bool scallop::resolve_hyper_edge(int fsize)
@@ -614,7 +675,7 @@ int scallop::init_super_edges()
 		vector<int> v;
 		int s = (*it1)->source();
 		v.push_back(s);
-		mev.insert(PEV(*it1, v));
+		mev[*it1] = v;
 	}
 	return 0;
 }
@@ -776,14 +837,13 @@ int scallop::decompose_vertex_extend(int root, MPID &pe2w)
 		
 			int z = i2e.size();
 			i2e.push_back(p);
-			e2i.insert(PEI(p, z));
+			e2i[p] = z;
 
 			gr.set_edge_weight(p, w);
 			gr.set_edge_info(p, edge_info());
 
 			vector<int> v0;
-			if(mev.find(p) != mev.end()) mev[p] = v0;
-			else mev.insert(PEV(p, v0));
+			mev[p] = v0;
 
 			hs.insert_between(e1, e2, z);
 		}
@@ -966,7 +1026,7 @@ int scallop::split_merge_path(const VE &p, double wx)
 	for(int i = 0; i < p.size(); i++)
 	{
 		assert(p[i] != null_edge);
-		assert(e2i.find(p[i]) != e2i.end());
+		assert(e2i.contain(p[i]));
 		v.push_back(e2i[p[i]]);
 		double w = gr.get_edge_weight(p[i]);
 	}
@@ -1007,8 +1067,8 @@ int scallop::merge_adjacent_equal_edges(int x, int y)
 
 	int n = i2e.size();
 	i2e.push_back(p);
-	assert(e2i.find(p) == e2i.end());
-	e2i.insert(PEI(p, n));
+	assert(e2i.contain(p) == false);
+	e2i[p] = n;
 
 	double wx0 = gr.get_edge_weight(xx);
 	double wy0 = gr.get_edge_weight(yy);
@@ -1023,10 +1083,10 @@ int scallop::merge_adjacent_equal_edges(int x, int y)
 	gr.set_edge_info(p, edge_info(lxy));
 
 	vector<int> v = mev[xx];
-	v.insert(v.end(), mev[yy].begin(), mev[yy].end());
+	const vector<int> &vy = mev[yy];
+	v.insert(v.end(), vy.begin(), vy.end());
 
-	if(mev.find(p) != mev.end()) mev[p] = v;
-	else mev.insert(PEV(p, v));
+	mev[p] = v;
 
 	double sum1 = gr.get_in_weights(xt);
 	double sum2 = gr.get_out_weights(xt);
@@ -1036,7 +1096,7 @@ int scallop::merge_adjacent_equal_edges(int x, int y)
 	gr.set_vertex_weight(xt, r2);
 
 	assert(i2e[n] == p);
-	assert(e2i.find(p) != e2i.end());
+	assert(e2i.contain(p));
 	assert(e2i[p] == n);
 	assert(e2i[i2e[n]] == n);
 
@@ -1126,12 +1186,12 @@ int scallop::split_edge(int ei, double w)
 	gr.set_edge_weight(p2, w);			// new edge
 	gr.set_edge_info(p2, eif);			// new edge
 
-	if(mev.find(p2) != mev.end()) mev[p2] = mev[ee];
-	else mev.insert(PEV(p2, mev[ee]));
+	vector<int> v = mev[ee];
+	mev[p2] = v;
 
 	int n = i2e.size();
 	i2e.push_back(p2);
-	e2i.insert(PEI(p2, n));
+	e2i[p2] = n;
 
 	return n;
 }
@@ -1328,7 +1388,7 @@ int scallop::collect_existing_st_paths()
 
 int scallop::collect_path(int e)
 {
-	assert(mev.find(i2e[e]) != mev.end());
+	assert(mev.contain(i2e[e]));
 
 	vector<int> v0 = mev[i2e[e]];
 	vector<int> v;
@@ -1364,17 +1424,25 @@ int scallop::greedy_decompose()
 	for(int i = 1; i < gr.num_vertices() - 1; i++) balance_vertex(i);
 	for(int i = 1; i < gr.num_vertices() - 1; i++) balance_vertex(i);
 
+	// only the edges of each extracted path are reduced or removed
+	bottleneck_path bp(gr);
+
 	int cnt = 0;
 	int n1 = paths.size();
 	while(true)
 	{
 		VE v;
-		double w = gr.compute_maximum_path_w(v);
+		double w = bp.compute(v);
 		if(w <= min_transcript_coverage) break;
 
+		vector<int> vt;
+		for(int i = 0; i < v.size(); i++) vt.push_back(v[i]->target());
+
 		int e = split_merge_path(v, w);
 		collect_path(e);
 		cnt++;
+
+		for(int i = 0; i < vt.size(); i++) bp.invalidate(vt[i]);
 	}
 	int n2 = paths.size();
 	if(verbose >= 2) printf("greedy decomposing produces %d / %d paths\n", n2 - n1, n2);
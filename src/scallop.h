@@ -11,10 +11,10 @@ See LICENSE for licensing.
 #include "hyper_set.h"
 #include "equation.h"
 #include "router.h"
+#include "router_cache.h"
 #include "path.h"
 
-typedef map< edge_descriptor, vector<int> > MEV;
-typedef pair< edge_descriptor, vector<int> > PEV;
+typedef edge_property< vector<int> > EPV;
 typedef pair< vector<int>, vector<int> > PVV;
 typedef pair<PEE, int> PPEEI;
 typedef map<PEE, int> MPEEI;
@@ -27,6 +27,7 @@ class scallop
 public:
 	scallop();
 	scallop(const splice_graph &gr, const hyper_set &hs);
+	scallop(splice_graph &&gr, hyper_set &&hs);
 	virtual ~scallop();
 
 public:
@@ -34,18 +35,23 @@ public:
 
 public:
 	splice_graph gr;					// splice graph
-	MEI e2i;							// edge map, from edge to index
+	EPI e2i;							// edge map, from edge to index
 	VE i2e;								// edge map, from index to edge
-	MEV mev;							// super edges
+	EPV mev;							// super edges
 	vector<int> v2v;					// vertex map
 	hyper_set hs;						// hyper edges
 	int round;							// iteration
 	set<int> nonzeroset;				// vertices with degree >= 1
+	router_cache rc;					// routers of vertices, updated incrementally
 	vector<path> paths;					// predicted paths
 	vector<transcript> trsts;			// predicted transcripts
+	int64_t deadline;					// wall_clock() to stop resolving, 0 for no limit
+	size_t max_memory;					// arena size to stop resolving, 0 for no limit
+	bool fallback;						// whether resolving was stopped by the limits
 
 private:
 	// init
+	int init();
 	int classify();
 	int init_vertex_map();
 	int init_super_edges();
@@ -53,6 +59,7 @@ private:
 	int init_nonzeroset();
 	int add_pseudo_hyper_edges();
 	int refine_splice_graph();
+	bool over_budget() const;
 
 	// resolve iteratively
 	bool resolve_trivial_vertex(int type, double jump_ratio);
@@ -64,6 +71,11 @@ private:
 	bool resolve_unsplittable_vertex(int type, int degree, double max_ratio);
 	bool resolve_hyper_edge(int fsize);
 
+	// maintain routers of vertices
+	int refresh_routers();
+	int build_routers(int type, int degree);
+	int build_router_signature(int x, const MPII &mpi, router_signature &s);
+
 	// smooth vertex
 	int balance_vertex(int x);
 	double compute_balance_ratio(int x);
@@ -0,0 +1,258 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "simulator.h"
+#include "htslib/sam.h"
+#include "util.h"
+
+#include <cstdio>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+bool sim_read::operator< (const sim_read &r) const
+{
+	if(tid != r.tid) return tid < r.tid;
+	if(pos != r.pos) return pos < r.pos;
+	return name < r.name;
+}
+
+simulator::simulator(const genome &g)
+	: gm(g)
+{
+	depth = 10;
+	max_isoforms = 0;
+	intron_retention = 0.05;
+	paired_end = true;
+	read_length = 100;
+	fragment_length = 300;
+	nfrags = 0;
+}
+
+int simulator::simulate(int seed)
+{
+	rng.seed(seed);
+	reads.clear();
+	chrms.clear();
+	lens.clear();
+	nfrags = 0;
+
+	// chromosomes are sorted by name, and extend beyond the last exon
+	map<string, int32_t> m;
+	for(int i = 0; i < gm.genes.size(); i++)
+	{
+		const gene &g = gm.genes[i];
+		for(int j = 0; j < g.transcripts.size(); j++)
+		{
+			const transcript &t = g.transcripts[j];
+			int32_t r = t.get_bounds().second;
+			if(m.find(t.seqname) == m.end() || m[t.seqname] < r) m[t.seqname] = r;
+		}
+	}
+
+	map<string, int> c2i;
+	for(map<string, int32_t>::iterator it = m.begin(); it != m.end(); it++)
+	{
+		c2i[it->first] = chrms.size();
+		chrms.push_back(it->first);
+		lens.push_back(it->second + 1000);
+	}
+
+	for(int i = 0; i < gm.genes.size(); i++)
+	{
+		const gene &g = gm.genes[i];
+		int n = g.transcripts.size();
+		if(max_isoforms >= 1 && n > max_isoforms) n = max_isoforms;
+		for(int j = 0; j < n; j++)
+		{
+			const transcript &t = g.transcripts[j];
+			double abundance = exp(gaussian());
+			simulate(t, c2i[t.seqname], abundance);
+		}
+	}
+
+	sort(reads.begin(), reads.end());
+	return 0;
+}
+
+int simulator::simulate(const transcript &t, int tid, double abundance)
+{
+	vector<PI32> v = t.exons;
+	sort(v.begin(), v.end());
+	if(v.size() == 0) return 0;
+
+	// a variant of this transcript with one intron retained
+	vector<PI32> w = v;
+	if(w.size() >= 2)
+	{
+		int k = rng() % (w.size() - 1);
+		w[k].second = w[k + 1].second;
+		w.erase(w.begin() + k + 1);
+	}
+
+	int lv = 0;
+	int lw = 0;
+	for(int k = 0; k < v.size(); k++) lv += v[k].second - v[k].first;
+	for(int k = 0; k < w.size(); k++) lw += w[k].second - w[k].first;
+
+	if(lv < read_length) return 0;
+
+	int bases = paired_end ? 2 * read_length : read_length;
+	int64_t n = (int64_t)(depth * abundance * lv / bases + uniform());
+
+	for(int64_t i = 0; i < n; i++)
+	{
+		bool retained = (v.size() >= 2 && uniform() < intron_retention);
+		const vector<PI32> &x = retained ? w : v;
+		int lx = retained ? lw : lv;
+
+		nfrags++;
+
+		if(paired_end == false)
+		{
+			sim_read r;
+			int32_t s = rng() % (lx - read_length + 1);
+			uint16_t flag = (rng() % 2 == 0) ? 0 : 0x10;
+			add_read(x, tid, s, read_length, t.strand, flag, r);
+			reads.push_back(r);
+			continue;
+		}
+
+		int f = (int)(fragment_length + 0.1 * fragment_length * gaussian() + 0.5);
+		if(f > lx) f = lx;
+		if(f < read_length) f = read_length;
+
+		int32_t s = rng() % (lx - f + 1);
+		bool first = (rng() % 2 == 0);
+
+		sim_read r1, r2;
+		add_read(x, tid, s, read_length, t.strand, 0x1 | 0x2 | 0x20 | (first ? 0x40 : 0x80), r1);
+		add_read(x, tid, s + f - read_length, read_length, t.strand, 0x1 | 0x2 | 0x10 | (first ? 0x80 : 0x40), r2);
+
+		int32_t isize = r2.rpos - r1.pos;
+		r1.mpos = r2.pos;
+		r2.mpos = r1.pos;
+		r1.isize = isize;
+		r2.isize = -isize;
+		reads.push_back(r1);
+		reads.push_back(r2);
+	}
+	return 0;
+}
+
+int simulator::add_read(const vector<PI32> &v, int tid, int32_t s, int32_t l, char xs, uint16_t flag, sim_read &r)
+{
+	// map [s, s + l) of the transcript to the reference
+	r.tid = tid;
+	r.pos = -1;
+	r.rpos = -1;
+	r.mpos = -1;
+	r.isize = 0;
+	r.flag = flag;
+	r.xs = '.';
+	r.name = nfrags;
+	r.cigar = "";
+
+	int32_t off = 0;
+	int32_t prev = -1;
+	for(int k = 0; k < v.size() && l > 0; k++)
+	{
+		int32_t e = v[k].second - v[k].first;
+		if(s >= off + e)
+		{
+			off += e;
+			continue;
+		}
+
+		int32_t a = v[k].first + (s > off ? s - off : 0);
+		int32_t b = (a + l < v[k].second) ? a + l : v[k].second;
+
+		if(prev >= 0) r.cigar += tostring(a - prev) + "N";
+		if(prev < 0) r.pos = a;
+		r.cigar += tostring(b - a) + "M";
+
+		l -= b - a;
+		prev = b;
+		off += e;
+	}
+
+	assert(l == 0);
+	r.rpos = prev;
+	if(r.cigar.find('N') != string::npos && (xs == '+' || xs == '-')) r.xs = xs;
+	return 0;
+}
+
+int simulator::write(const string &file)
+{
+	string text = "@HD\tVN:1.0\tSO:coordinate\n";
+	for(int i = 0; i < chrms.size(); i++)
+	{
+		text += "@SQ\tSN:" + chrms[i] + "\tLN:" + tostring(lens[i]) + "\n";
+	}
+
+	samFile *fo = sam_open(file.c_str(), "wb");
+	if(fo == NULL)
+	{
+		printf("error: cannot write to %s\n", file.c_str());
+		return -1;
+	}
+
+	bam_hdr_t *h = sam_hdr_parse(text.size(), text.c_str());
+	sam_hdr_write(fo, h);
+
+	bam1_t *b = bam_init1();
+	vector<char> buf;
+	int e = 0;
+	for(int i = 0; i < reads.size() && e == 0; i++)
+	{
+		const sim_read &r = reads[i];
+		buf.resize(r.cigar.size() + chrms[r.tid].size() + 128);
+
+		int n = snprintf(buf.data(), buf.size(), "s%lld\t%d\t%s\t%d\t60\t%s\t%s\t%d\t%d\t*\t*\tNH:i:1",
+				(long long)r.name, r.flag, chrms[r.tid].c_str(), r.pos + 1, r.cigar.c_str(),
+				r.mpos >= 0 ? "=" : "*", r.mpos + 1, r.isize);
+		if(r.xs != '.') n += snprintf(buf.data() + n, buf.size() - n, "\tXS:A:%c", r.xs);
+
+		kstring_t ks;
+		ks.s = buf.data();
+		ks.l = n;
+		ks.m = buf.size();
+		if(sam_parse1(&ks, h, b) < 0) e = -1;
+		else if(sam_write1(fo, h, b) < 0) e = -1;
+	}
+
+	bam_destroy1(b);
+	bam_hdr_destroy(h);
+	sam_close(fo);
+
+	if(e != 0)
+	{
+		printf("error: failed to write alignments to %s\n", file.c_str());
+		return -1;
+	}
+
+	// an index allows reading chromosomes in parallel
+	sam_index_build(file.c_str(), 0);
+	return 0;
+}
+
+size_t simulator::num_reads() const
+{
+	return reads.size();
+}
+
+double simulator::uniform()
+{
+	return (rng() + 0.5) / 4294967296.0;
+}
+
+double simulator::gaussian()
+{
+	// Box-Muller, independent of the standard library
+	double u1 = uniform();
+	double u2 = uniform();
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
@@ -0,0 +1,74 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __SIMULATOR_H__
+#define __SIMULATOR_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+
+#include "genome.h"
+
+using namespace std;
+
+// a simulated alignment
+class sim_read
+{
+public:
+	int32_t tid;					// chromosome
+	int32_t pos;					// leftmost position, 0-based
+	int32_t rpos;					// rightmost position, exclusive
+	int32_t mpos;					// position of mate, -1 if single-end
+	int32_t isize;					// insert size
+	uint16_t flag;					// sam flag
+	char xs;						// strand of spliced reads, '.' otherwise
+	int64_t name;					// fragment id
+	string cigar;
+
+public:
+	bool operator< (const sim_read &r) const;
+};
+
+// generate sorted RNA-seq alignments from the transcripts of a
+// reference; abundances are log-normal, and a fraction of the
+// fragments of each multi-exon transcript retain one of its introns
+class simulator
+{
+public:
+	simulator(const genome &g);
+
+public:
+	double depth;					// average read coverage of a transcript
+	int max_isoforms;				// transcripts used for each gene, 0 for all
+	double intron_retention;		// fraction of fragments with a retained intron
+	bool paired_end;				// whether fragments are sequenced at both ends
+	int read_length;				// length of each read
+	int fragment_length;			// mean length of fragments
+
+private:
+	const genome &gm;
+	mt19937 rng;					// portable generator, for reproducibility
+	vector<string> chrms;			// chromosomes, sorted by name
+	vector<int32_t> lens;			// length of each chromosome
+	vector<sim_read> reads;			// simulated alignments
+	int64_t nfrags;					// number of fragments
+
+public:
+	int simulate(int seed);
+	int write(const string &file);
+	size_t num_reads() const;
+
+private:
+	int simulate(const transcript &t, int tid, double abundance);
+	int add_read(const vector<PI32> &v, int tid, int32_t s, int32_t l, char xs, uint16_t flag, sim_read &r);
+	double uniform();
+	double gaussian();
+};
+
+#endif
@@ -8,6 +8,7 @@ See LICENSE for licensing.
 #include "util.h"
 #include "config.h"
 #include "interval_map.h"
+#include "csr_graph.h"
 #include <sstream>
 #include <fstream>
 #include <cfloat>
@@ -18,10 +19,13 @@ See LICENSE for licensing.
 using namespace std;
 
 splice_graph::splice_graph()
-{}
+{
+	tracking = false;
+}
 
 splice_graph::splice_graph(const splice_graph &gr)
 {
+	tracking = false;
 	chrm = gr.chrm;
 	gid = gr.gid;
 	strand = gr.strand;
@@ -31,6 +35,27 @@ splice_graph::splice_graph(const splice_graph &gr)
 	copy(gr, x2y, y2x);
 }
 
+splice_graph::splice_graph(splice_graph &&gr) noexcept
+	: directed_graph(std::move(gr)),
+	chrm(std::move(gr.chrm)), gid(std::move(gr.gid)), strand(gr.strand),
+	vwrt(std::move(gr.vwrt)), vinf(std::move(gr.vinf)),
+	ewrt(std::move(gr.ewrt)), einf(std::move(gr.einf)),
+	tracking(gr.tracking), changes(std::move(gr.changes))
+{}
+
+splice_graph& splice_graph::operator=(const splice_graph &gr)
+{
+	if(this == &gr) return *this;
+	chrm = gr.chrm;
+	gid = gr.gid;
+	strand = gr.strand;
+
+	MEE x2y;
+	MEE y2x;
+	copy(gr, x2y, y2x);
+	return *this;
+}
+
 int splice_graph::copy(const splice_graph &gr, MEE &x2y, MEE &y2x)
 {
 	clear();
@@ -49,8 +74,8 @@ int splice_graph::copy(const splice_graph &gr, MEE &x2y, MEE &y2x)
 		set_edge_info(e, gr.get_edge_info(*it));
 
 		assert(e != NULL);
-		assert(ewrt.find(e) != ewrt.end());
-		assert(einf.find(e) != einf.end());
+		assert(ewrt.contain(e));
+		assert(einf.contain(e));
 		assert(x2y.find(*it) == x2y.end());
 		assert(y2x.find(e) == y2x.end());
 
@@ -61,6 +86,37 @@ int splice_graph::copy(const splice_graph &gr, MEE &x2y, MEE &y2x)
 	return 0;
 }
 
+edge_descriptor splice_graph::add_edge(int s, int t)
+{
+	if(tracking == true) changes.push_back(s);
+	if(tracking == true) changes.push_back(t);
+	return directed_graph::add_edge(s, t);
+}
+
+int splice_graph::remove_edge(edge_descriptor e)
+{
+	if(tracking == true) changes.push_back(e->source());
+	if(tracking == true) changes.push_back(e->target());
+	return directed_graph::remove_edge(e);
+}
+
+int splice_graph::remove_edge(int s, int t)
+{
+	return directed_graph::remove_edge(s, t);
+}
+
+int splice_graph::move_edge(edge_base *e, int x, int y)
+{
+	if(tracking == true)
+	{
+		changes.push_back(e->source());
+		changes.push_back(e->target());
+		changes.push_back(x);
+		changes.push_back(y);
+	}
+	return directed_graph::move_edge(e, x, y);
+}
+
 int splice_graph::clear()
 {
 	directed_graph::clear();
@@ -68,6 +124,7 @@ int splice_graph::clear()
 	vinf.clear();
 	ewrt.clear();
 	einf.clear();
+	changes.clear();
 	return 0;
 }
 
@@ -88,16 +145,12 @@ vertex_info splice_graph::get_vertex_info(int v) const
 
 double splice_graph::get_edge_weight(edge_base *e) const
 {
-	MED::const_iterator it = ewrt.find(e);
-	assert(it != ewrt.end());
-	return it->second;
+	return ewrt.get(e);
 }
 
 edge_info splice_graph::get_edge_info(edge_base *e) const
 {
-	MEIF::const_iterator it = einf.find(e);
-	assert(it != einf.end());
-	return it->second;
+	return einf.get(e);
 }
 
 int splice_graph::set_vertex_weight(int v, double w) 
@@ -118,21 +171,28 @@ int splice_graph::set_vertex_info(int v, const vertex_info &vi)
 
 int splice_graph::set_edge_weight(edge_base* e, double w) 
 {
-	if(ewrt.find(e) != ewrt.end()) ewrt[e] = w;
-	else ewrt.insert(PED(e, w));
+	if(tracking == true) changes.push_back(e->source());
+	if(tracking == true) changes.push_back(e->target());
+	ewrt[e] = w;
 	return 0;
 }
 
 int splice_graph::set_edge_info(edge_base* e, const edge_info &ei) 
 {
-	if(einf.find(e) != einf.end()) einf[e] = ei;
-	else einf.insert(PEIF(e, ei));
+	einf[e] = ei;
 	return 0;
 }
 
 MED splice_graph::get_edge_weights() const
 {
-	return ewrt;
+	MED med;
+	PEEI pei = edges();
+	for(edge_iterator it = pei.first; it != pei.second; it++)
+	{
+		if(ewrt.contain(*it) == false) continue;
+		med.insert(PED(*it, ewrt.get(*it)));
+	}
+	return med;
 }
 
 vector<double> splice_graph::get_vertex_weights() const
@@ -142,7 +202,11 @@ vector<double> splice_graph::get_vertex_weights() const
 
 int splice_graph::set_edge_weights(const MED &med)
 {
-	ewrt = med;
+	ewrt.clear();
+	for(MED::const_iterator it = med.begin(); it != med.end(); it++)
+	{
+		ewrt[it->first] = it->second;
+	}
 	return 0;
 }
 
@@ -360,6 +424,72 @@ int splice_graph::write(const string &file) const
 	return 0;
 }
 
+int splice_graph::serialize(binary_writer &w) const
+{
+	w.put(chrm);
+	w.put(gid);
+	w.put(strand);
+
+	w.put((uint32_t)(num_vertices()));
+	for(int i = 0; i < num_vertices(); i++)
+	{
+		w.put(get_vertex_weight(i));
+		get_vertex_info(i).serialize(w);
+	}
+
+	w.put((uint32_t)(num_edges()));
+	edge_iterator it1, it2;
+	PEEI pei;
+	for(pei = edges(), it1 = pei.first, it2 = pei.second; it1 != it2; it1++)
+	{
+		w.put((int32_t)((*it1)->source()));
+		w.put((int32_t)((*it1)->target()));
+		w.put(get_edge_weight(*it1));
+		get_edge_info(*it1).serialize(w);
+	}
+	return 0;
+}
+
+int splice_graph::deserialize(binary_reader &r)
+{
+	clear();
+	r.get(chrm);
+	r.get(gid);
+	r.get(strand);
+
+	uint32_t n;
+	r.get(n);
+	for(int i = 0; i < n && r.fail() == false; i++)
+	{
+		double w;
+		vertex_info vi;
+		r.get(w);
+		vi.deserialize(r);
+		add_vertex();
+		set_vertex_weight(i, w);
+		set_vertex_info(i, vi);
+	}
+
+	uint32_t m;
+	r.get(m);
+	for(int i = 0; i < m && r.fail() == false; i++)
+	{
+		int32_t s, t;
+		double w;
+		edge_info ei;
+		r.get(s);
+		r.get(t);
+		r.get(w);
+		ei.deserialize(r);
+		if(s < 0 || s >= n || t < 0 || t >= n || s == t) return -1;
+
+		edge_descriptor e = add_edge(s, t);
+		set_edge_weight(e, w);
+		set_edge_info(e, ei);
+	}
+	return r.fail() ? -1 : 0;
+}
+
 int splice_graph::simulate(int nv, int ne, int mw)
 {
 	clear();
@@ -383,9 +513,9 @@ int splice_graph::simulate(int nv, int ne, int mw)
 		if(p.second == true) continue;
 
 		edge_descriptor e = add_edge(s, t);
-		ewrt.insert(PED(e, f));
-		einf.insert(PEIF(e, edge_info()));
-		if(ewrt.size() >= ne) break;
+		ewrt[e] = f;
+		einf[e] = edge_info();
+		if(num_edges() >= ne) break;
 	}
 
 	assert(in_degree(0) == 0);
@@ -405,16 +535,19 @@ int splice_graph::simulate(int nv, int ne, int mw)
 		}
 	}
 
-	for(MED::iterator it = ewrt.begin(); it != ewrt.end(); it++)
+	VE ve;
+	PEEI pe = edges();
+	for(edge_iterator it = pe.first; it != pe.second; it++)
 	{
-		if(med.find(it->first) == med.end()) remove_edge(it->first);
+		if(med.find(*it) == med.end()) ve.push_back(*it);
 	}
+	for(int i = 0; i < ve.size(); i++) remove_edge(ve[i]);
 
-	ewrt = med;
+	set_edge_weights(med);
 	einf.clear();
-	for(MED::iterator it = ewrt.begin(); it != ewrt.end(); it++)
+	for(MED::iterator it = med.begin(); it != med.end(); it++)
 	{
-		einf.insert(PEIF(it->first, edge_info()));
+		einf[it->first] = edge_info();
 	}
 
 	edge_iterator it1, it2;
@@ -473,18 +606,15 @@ long splice_graph::compute_num_paths()
 	int n = num_vertices();
 	table.resize(n, 0);
 	table[0] = 1;
+	csr_graph cg(*this);
 	for(int i = 1; i < n; i++)
 	{
-		edge_iterator it1, it2;
-		PEEI pei;
-		for(pei = in_edges(i), it1 = pei.first, it2 = pei.second; it1 != it2; it1++)
+		for(int j = cg.ip[i]; j < cg.ip[i + 1]; j++)
 		{
-			int s = (*it1)->source();
-			int t = (*it1)->target();
-			assert(t == i);
+			int s = cg.is[j];
 			//assert(s < i);
-			table[t] += table[s];
-			if(table[t] >= max) return max;
+			table[i] += table[s];
+			if(table[i] >= max) return max;
 		}
 	}
 	
@@ -708,7 +838,8 @@ double splice_graph::compute_maximum_st_path_w(VE &p, int ss, int tt)
 	table.resize(num_vertices(), -1);
 	back.resize(num_vertices(), null_edge);
 
-	vector<int> tp = topological_sort();
+	csr_graph cg(*this);
+	vector<int> tp = cg.topological_sort();
 	int n = num_vertices();
 	assert(tp.size() == n);
 	//assert(tp[0] == 0);
@@ -728,24 +859,20 @@ double splice_graph::compute_maximum_st_path_w(VE &p, int ss, int tt)
 	for(int ii = ssi + 1; ii <= tti; ii++)
 	{
 		int i = tp[ii];
-		if(degree(i) == 0) continue;
+		if(cg.in_degree(i) + cg.out_degree(i) == 0) continue;
 
 		double max_abd = 0;
 		edge_descriptor max_edge = null_edge;
-		edge_iterator it1, it2;
-		PEEI pei;
-		for(pei = in_edges(i), it1 = pei.first, it2 = pei.second; it1 != it2; it1++)
+		for(int j = cg.ip[i]; j < cg.ip[i + 1]; j++)
 		{
-			int s = (*it1)->source();
-			int t = (*it1)->target();
-			assert(t == i);
+			int s = cg.is[j];
 			if(table[s] <= -1) continue;
-			double xw = get_edge_weight(*it1);
+			double xw = get_edge_weight(cg.ie[j]);
 			double ww = xw < table[s] ? xw : table[s];
 			if(ww >= max_abd)
 			{
 				max_abd = ww;
-				max_edge = *it1;
+				max_edge = cg.ie[j];
 			}
 		}
 
@@ -875,10 +1002,11 @@ int splice_graph::locate(int v)
 
 int splice_graph::round_weights()
 {
-	MED m = ewrt;
-	for(MED::iterator it = m.begin(); it != m.end(); it++)
+	EPD m;
+	PEEI pe = edges();
+	for(edge_iterator it = pe.first; it != pe.second; it++)
 	{
-		it->second = 0.0;
+		m[*it] = 0.0;
 	}
 
 	while(true)
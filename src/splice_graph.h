@@ -8,6 +8,7 @@ See LICENSE for licensing.
 #define __SPLICE_GRAPH_H__
 
 #include "directed_graph.h"
+#include "edge_property.h"
 #include "vertex_info.h"
 #include "edge_info.h"
 #include "path.h"
@@ -22,13 +23,17 @@ using namespace std;
 
 typedef map<edge_descriptor, edge_info> MEIF;
 typedef pair<edge_descriptor, edge_info> PEIF;
+typedef edge_property<double> EPD;
+typedef edge_property<edge_info> EPIF;
 
 class splice_graph : public directed_graph
 {
 public:
 	splice_graph();
 	splice_graph(const splice_graph &gr);
+	splice_graph(splice_graph &&gr) noexcept;
 	virtual ~splice_graph();
+	splice_graph& operator=(const splice_graph &gr);
 
 public:
 	string chrm;
@@ -37,8 +42,11 @@ public:
 
 	vector<double> vwrt;
 	vector<vertex_info> vinf;
-	MED ewrt;
-	MEIF einf;
+	EPD ewrt;				// edge weights, indexed by edge id
+	EPIF einf;				// edge infos, indexed by edge id
+
+	bool tracking;			// whether to record changed vertices
+	vector<int> changes;	// endpoints of added, removed, moved or reweighted edges
 
 public:
 	// get and set properties
@@ -67,12 +75,18 @@ public:
 	int count_junctions();
 
 	// modify the splice_graph
+	edge_descriptor add_edge(int s, int t);
+	int remove_edge(edge_descriptor e);
+	int remove_edge(int s, int t);
+	int move_edge(edge_base *e, int x, int y);
 	int clear();
 	int copy(const splice_graph &gr, MEE &x2y, MEE &y2x);
 
 	// read, write, and simulate splice graph
 	int build(const string &file);
 	int write(const string &file) const;
+	int serialize(binary_writer &w) const;
+	int deserialize(binary_reader &r);
 	int simulate(int nv, int ne, int mf);
 
 	// analysis the structure of splice graph
@@ -35,7 +35,7 @@ int subsetsum::rescale()
 	for(int i = 0; i < target.size(); i++) s2 += target[i].first;
 
 	int ubound = (s1 > s2) ? s1 : s2;
-	if(ubound > 1000) ubound = 1000;
+	if(ubound > max_dp_table_size) ubound = max_dp_table_size;
 
 	double r1 = ubound * 1.0 / s1;
 	double r2 = ubound * 1.0 / s2;
@@ -69,130 +69,138 @@ int subsetsum::rescale()
 	return 0;
 }
 
-int subsetsum::init(const vector<PI> &vv, vector< vector<int> > &table, int ubound)
+// number of 64-bit words in a row covering sums 0..ubound
+static inline int row_words(int ubound)
 {
-	table.resize(vv.size() + 1);
-	for(int i = 0; i < table.size(); i++)
-	{
-		table[i].assign(ubound + 1, -1);
-	}
+	return ubound / 64 + 1;
+}
 
-	for(int i = 0; i <= vv.size(); i++)
-	{
-		table[i][0] = 0;
-	}
+// whether sum j is reachable with the first i numbers
+static inline bool row_test(const vector<uint64_t> &table, int ubound, int i, int j)
+{
+	const uint64_t *r = &table[(size_t)i * row_words(ubound)];
+	return (r[j >> 6] >> (j & 63)) & 1;
+}
 
-	for(int j = 1; j <= ubound; j++)
-	{
-		table[0][j] = -1;
-	}
+int subsetsum::init(const vector<PI> &vv, vector<uint64_t> &table, int ubound)
+{
+	int w = row_words(ubound);
+	table.assign((size_t)(vv.size() + 1) * w, 0);
+	table[0] = 1;
 	return 0;
 }
 
-int subsetsum::fill(const vector<PI> &vv, vector< vector<int> > &table, int ubound)
+int subsetsum::fill(const vector<PI> &vv, vector<uint64_t> &table, int ubound)
 {
-	for(int j = 1; j <= ubound; j++)
+	// row i = row i-1 | (row i-1 << s), by whole words plus a bit carry
+	int w = row_words(ubound);
+	for(int i = 1; i <= vv.size(); i++)
 	{
-		for(int i = 1; i <= vv.size(); i++)
+		const uint64_t *a = &table[(size_t)(i - 1) * w];
+		uint64_t *b = &table[(size_t)i * w];
+		int s = vv[i - 1].first;
+		int q = s >> 6;
+		int r = s & 63;
+		for(int k = 0; k < w; k++)
 		{
-			int s = vv[i - 1].first;
-			if(j >= s && table[i - 1][j - s] >= 0)
-			{
-				table[i][j] = i;
-			}
-			
-			if(table[i - 1][j] >= 0)
-			{
-				table[i][j] = table[i - 1][j];
-			}
+			uint64_t x = a[k];
+			if(k >= q) x |= (a[k - q] << r);
+			if(k >= q + 1 && r != 0) x |= (a[k - q - 1] >> (64 - r));
+			b[k] = x;
 		}
+		int e = (ubound + 1) & 63;
+		if(e != 0) b[w - 1] &= ((uint64_t)(1) << e) - 1;
 	}
 	return 0;
 }
 
-int subsetsum::backtrace(int t, const vector<PI> &vv, const vector< vector<int> > &table, vector<int> &ss)
+int subsetsum::next(const vector<uint64_t> &table, int ubound, int i, int j) const
+{
+	// smallest reachable sum >= j in row i, or -1
+	int w = row_words(ubound);
+	if(j > ubound) return -1;
+	const uint64_t *r = &table[(size_t)i * w];
+	int k = j >> 6;
+	uint64_t x = r[k] & (~(uint64_t)(0) << (j & 63));
+	while(x == 0)
+	{
+		if(++k >= w) return -1;
+		x = r[k];
+	}
+	return (k << 6) + __builtin_ctzll(x);
+}
+
+int subsetsum::first(const vector<uint64_t> &table, int ubound, int i, int j) const
+{
+	// smallest i' <= i such that sum j is reachable with the first i' numbers
+	if(row_test(table, ubound, i, j) == false) return -1;
+	while(i >= 1 && row_test(table, ubound, i - 1, j) == true) i--;
+	return i;
+}
+
+int subsetsum::backtrace(int t, const vector<PI> &vv, const vector<uint64_t> &table, int ubound, vector<int> &ss)
 {
 	ss.clear();
 	if(table.size() <= 0) return -1;
-	if(t <= 0 || t > table[0].size()) return -1;
+	if(t <= 0 || t > ubound) return -1;
 	int n = vv.size();
-	if(table[n][t] == -1) return -1;
-
-	//ss.push_back(vv[vi].second);
+	int s = first(table, ubound, n, t);
+	if(s == -1) return -1;
 
 	int x = t;
-	int s = table[n][t];
 	while(x >= 1 && s >= 1)
 	{
-		assert(table[s][x] >= 0);
+		assert(row_test(table, ubound, s, x));
 		ss.push_back(vv[s - 1].second);
 
 		x -= vv[s - 1].first;
-		s = table[s - 1][x];
+		s = first(table, ubound, s - 1, x);
 	}
 	return 0;
 }
 
 int subsetsum::optimize()
 {
-	vector<PI> v;
 	int n1 = source.size();
 	int n2 = target.size();
 
-	//v.push_back(PI(0, 0));
-
-	for(int i = 1; i <= ubound1; i++)
-	{
-		if(table1[n1][i] < 0) continue;
-		v.push_back(PI(i, 1));
-	}
-	for(int i = 1; i <= ubound2; i++)
-	{
-		if(table2[n2][i] < 0) continue;
-		v.push_back(PI(i, 2));
-	}
-
-	sort(v.begin(), v.end());
-
-	/*
-	printf("source: ");
-	for(int i = 0; i < source.size(); i++) printf("%d:%d, ", source[i].second, source[i].first);
-	printf("\n");
-	printf("target: ");
-	for(int i = 0; i < target.size(); i++) printf("%d:%d, ", target[i].second, target[i].first);
-	printf("\n");
-
-	for(int k = 0; k < v.size(); k++) printf("%d:%d ", v[k].first, v[k].second);
-	printf("\n");
-	*/
-
+	// walk the reachable sums of both sides in increasing order,
+	// and find the closest pair coming from different sides
 	int d = INT_MAX;
-	int k = -1;
-	for(int i = 0; i < v.size() - 1; i++)
+	PI a(-1, -1), b(-1, -1);
+	PI p(-1, -1);
+	int i1 = next(table1, ubound1, n1, 1);
+	int i2 = next(table2, ubound2, n2, 1);
+	while(i1 != -1 || i2 != -1)
 	{
-		if(v[i].second == v[i + 1].second) continue;
-		if(v[i + 1].first - v[i].first >= d) continue;
-
-		/*
-		bool b1 = false, b2 = false;
-		if(v[i].second == 1 && v[i].first == ubound1) b1 = true;
-		if(v[i].second == 2 && v[i].first == ubound2) b1 = true;
-		if(v[i + 1].second == 1 && v[i + 1].first == ubound1) b2 = true;
-		if(v[i + 1].second == 2 && v[i + 1].first == ubound2) b2 = true;
-		if(b1 == true && b2 == true) continue;
-		*/
-
-		d = v[i + 1].first - v[i].first;
-		k = i;
+		PI c;
+		if(i2 == -1 || (i1 != -1 && i1 <= i2))
+		{
+			c = PI(i1, 1);
+			i1 = next(table1, ubound1, n1, i1 + 1);
+		}
+		else
+		{
+			c = PI(i2, 2);
+			i2 = next(table2, ubound2, n2, i2 + 1);
+		}
+
+		if(p.second != -1 && p.second != c.second && c.first - p.first < d)
+		{
+			d = c.first - p.first;
+			a = p;
+			b = c;
+		}
+		p = c;
 	}
 
-	assert(k != -1);
+	assert(a.second != -1);
 
-	if(v[k].second == 1) backtrace(v[k].first, source, table1, eqn.s);
-	else if(v[k].second == 2) backtrace(v[k].first, target, table2, eqn.t);
+	if(a.second == 1) backtrace(a.first, source, table1, ubound1, eqn.s);
+	else if(a.second == 2) backtrace(a.first, target, table2, ubound2, eqn.t);
 
-	if(v[k + 1].second == 1) backtrace(v[k + 1].first, source, table1, eqn.s);
-	else if(v[k + 1].second == 2) backtrace(v[k + 1].first, target, table2, eqn.t);
+	if(b.second == 1) backtrace(b.first, source, table1, ubound1, eqn.s);
+	else if(b.second == 2) backtrace(b.first, target, table2, ubound2, eqn.t);
 
 	int s = 0;
 	for(int i = 0; i < source.size(); i++) s += source[i].first;
@@ -215,30 +223,30 @@ int subsetsum::print()
 
 	printf("table 1\n");
 	printf("   ");
-	for(int i = 0; i < table1[0].size(); i++) printf("%3d", i);
+	for(int j = 0; j <= ubound1; j++) printf("%3d", j);
 	printf("\n");
 
-	for(int i = 0; i < table1.size(); i++)
+	for(int i = 0; i <= source.size(); i++)
 	{
 		printf("%3d", i);
-		for(int j = 0; j < table1[i].size(); j++)
+		for(int j = 0; j <= ubound1; j++)
 		{
-			printf("%3d", table1[i][j]);
+			printf("%3d", first(table1, ubound1, i, j));
 		}
 		printf("\n");
 	}
 
 	printf("table 2\n");
 	printf("   ");
-	for(int i = 0; i < table2[0].size(); i++) printf("%3d", i);
+	for(int j = 0; j <= ubound2; j++) printf("%3d", j);
 	printf("\n");
 
-	for(int i = 0; i < table2.size(); i++)
+	for(int i = 0; i <= target.size(); i++)
 	{
 		printf("%3d", i);
-		for(int j = 0; j < table2[i].size(); j++)
+		for(int j = 0; j <= ubound2; j++)
 		{
-			printf("%3d", table2[i][j]);
+			printf("%3d", first(table2, ubound2, i, j));
 		}
 		printf("\n");
 	}
@@ -8,6 +8,7 @@ See LICENSE for licensing.
 #define __SUBSETSUM4_H__
 
 #include <vector>
+#include <stdint.h>
 #include "equation.h"
 
 using namespace std;
@@ -27,8 +28,8 @@ private:
 	vector<PI> target;					// given target numbers
 	int ubound1;						// ubound for source
 	int ubound2;						// ubound for target
-	vector< vector<int> > table1;		// dp table2
-	vector< vector<int> > table2;		// dp table2
+	vector<uint64_t> table1;			// dp table1, one bitset row per prefix
+	vector<uint64_t> table2;			// dp table2, one bitset row per prefix
 
 public:
 	equation eqn;
@@ -40,10 +41,12 @@ public:
 
 private:
 	int rescale();
-	int init(const vector<PI> &vv, vector< vector<int> > &table, int ubound);
-	int fill(const vector<PI> &vv, vector< vector<int> > &table, int ubound);
-	int backtrace(int vi, const vector<PI> &vv, const vector< vector<int> > &table, vector<int> &ss);
+	int init(const vector<PI> &vv, vector<uint64_t> &table, int ubound);
+	int fill(const vector<PI> &vv, vector<uint64_t> &table, int ubound);
+	int backtrace(int t, const vector<PI> &vv, const vector<uint64_t> &table, int ubound, vector<int> &ss);
 	int optimize();
+	int next(const vector<uint64_t> &table, int ubound, int i, int j) const;
+	int first(const vector<uint64_t> &table, int ubound, int i, int j) const;
 };
 
 #endif
@@ -47,3 +47,34 @@ vertex_info::vertex_info(const vertex_info &vi)
 	lstrand = vi.lstrand;
 	rstrand = vi.rstrand;
 }
+
+int vertex_info::serialize(binary_writer &w) const
+{
+	w.put(pos);
+	w.put(lpos);
+	w.put(rpos);
+	w.put(stddev);
+	w.put((int32_t)(length));
+	w.put((int32_t)(sdist));
+	w.put((int32_t)(tdist));
+	w.put((int32_t)(type));
+	w.put(lstrand);
+	w.put(rstrand);
+	return 0;
+}
+
+int vertex_info::deserialize(binary_reader &r)
+{
+	int32_t x;
+	r.get(pos);
+	r.get(lpos);
+	r.get(rpos);
+	r.get(stddev);
+	r.get(x); length = x;
+	r.get(x); sdist = x;
+	r.get(x); tdist = x;
+	r.get(x); type = x;
+	r.get(lstrand);
+	r.get(rstrand);
+	return r.fail() ? -1 : 0;
+}
@@ -8,6 +8,7 @@ See LICENSE for licensing.
 #define __VERTEX_INFO__
 
 #include <stdint.h>
+#include "binary_io.h"
 
 class vertex_info
 {
@@ -27,6 +28,10 @@ public:
 	int type;			// for various usage
 	char lstrand;		// left side strand
 	char rstrand;		// right side strand	
+
+public:
+	int serialize(binary_writer &w) const;
+	int deserialize(binary_reader &r);
 };
 
 #endif